@@ -0,0 +1,331 @@
+/*! @file
+ *
+ *  @brief Checksum benchmark: times Packet_Put and Packet_Get with the XOR and the CRC-8 checksum and
+ *         counts the corrupted packets each of them lets through.
+ *
+ *  packet.c and CRC.c are built unchanged, with the UART replaced by buffers, as in PacketBench.
+ *    table    - CRC_Table8 is checked against a bitwise CRC-8 of every byte
+ *    timing   - ns per packet for Packet_Put into the transmit buffer and Packet_Get from a clean stream
+ *    errors   - random packets are corrupted, checked the way Packet_Get checks a window, and the errors
+ *               that still pass are counted: every 1, 2 and 3 bit error, every burst of 2 to 8 bits
+ *               (first and last bit flipped, the ones between either way), and random errors of 4 to 11 bits
+ *
+ *  The program exits with 1 if the CRC-8 lets through an error of 3 bits or fewer or a burst of 8 bits or
+ *  fewer, which it is guaranteed to catch.
+ *
+ *  Build and run from the top of the repository:
+ *    gcc -std=gnu99 -O2 -IHost -ISources -o checksumbench Host/ChecksumBench.c Sources/packet.c Sources/FIFO.c Sources/CRC.c
+ *    ./checksumbench
+ *
+ *  @author Liang Wang
+ *  @date 2016-08-11
+ */
+/*!
+**  @addtogroup ChecksumBench_module ChecksumBench module documentation
+**  @{
+*/
+/* MODULE ChecksumBench */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "packet.h"
+#include "CRC.h"
+
+#define NB_PACKETS 200000
+#define NB_RUNS 5
+#define NB_BITS (PACKET_NB_BYTES * 8)
+#define MAX_BURST 8
+#define NB_ERROR_PACKETS 200                          /*!<random packets each exhaustive error pattern is tried on*/
+#define NB_RANDOM_ERRORS 10000000
+
+static uint8_t *Stream;                               /*!<bytes UART_InChar hands out and UART_OutReserve takes*/
+static size_t StreamSize, StreamIndex;
+static uint8_t Out[PACKET_EXTENDED_NB_BYTES];
+
+BOOL UART_Init(const uint32_t baudRate, const uint32_t moduleClk)
+{
+  (void)baudRate;
+  (void)moduleClk;
+  return bTRUE;
+}
+
+void UART_SetRxCallback(void (*userFunction)(const uint8_t))
+{
+  (void)userFunction;
+}
+
+void UART_SetTxCallback(void (*userFunction)(void))
+{
+  (void)userFunction;
+}
+
+BOOL UART_InChar(uint8_t* const dataPtr)
+{
+  if (StreamIndex == StreamSize)
+    return bFALSE;
+  *dataPtr = Stream[StreamIndex++];
+  return bTRUE;
+}
+
+BOOL UART_OutReserve(const uint16_t nbBytes, TFIFOSpan* const span)
+{
+  if (nbBytes > sizeof(Out))
+    return bFALSE;
+  span->Data1 = Out;
+  span->Size1 = nbBytes;
+  span->Data2 = NULL;
+  span->Size2 = 0;
+  return bTRUE;
+}
+
+void UART_OutCommit(const uint16_t nbBytes)
+{
+  (void)nbBytes;
+}
+
+uint16_t UART_OutNbBytes(void)
+{
+  return 0;
+}
+
+/*! @brief Works out the CRC-8 of a byte a bit at a time, least significant bit first.
+ *
+ *  @return uint8_t - The CRC-8, reflected polynomial CRC_POLYNOMIAL8.
+ */
+static uint8_t BitwiseCRC(uint8_t crc)
+{
+  unsigned i;
+
+  for (i = 0; i < 8; i++)
+    crc = (crc & 1) ? (crc >> 1) ^ CRC_POLYNOMIAL8 : crc >> 1;
+  return crc;
+}
+
+/*! @brief Checks a packet as Packet_Get does.
+ *
+ *  @return int - Non-zero if the packet passes.
+ */
+static int Passes(const uint8_t *bytes, const TPacketChecksum checksum)
+{
+  if (checksum == PACKET_CHECKSUM_CRC8)
+    return CRC_8(bytes, PACKET_NB_BYTES - 1) == bytes[4];
+  return (bytes[0] ^ bytes[1] ^ bytes[2] ^ bytes[3] ^ bytes[4]) == 0;
+}
+
+/*! @brief Makes a random plain packet with a valid checksum.
+ *
+ *  @return void
+ */
+static void MakePacket(uint8_t *bytes, const TPacketChecksum checksum)
+{
+  unsigned i;
+
+  for (i = 0; i < PACKET_NB_BYTES - 1; i++)
+    bytes[i] = rand();
+  bytes[0] &= ~PACKET_TAG_MASK;
+  bytes[4] = (checksum == PACKET_CHECKSUM_CRC8) ? CRC_8(bytes, PACKET_NB_BYTES - 1) : bytes[0] ^ bytes[1] ^ bytes[2] ^ bytes[3];
+}
+
+/*! @brief Flips a bit of a packet, bits are numbered in the order the UART sends them.
+ *
+ *  @return void
+ */
+static void Flip(uint8_t *bytes, const unsigned bit)
+{
+  bytes[bit / 8] ^= 1 << (bit % 8);
+}
+
+/*! @brief Times Packet_Put and Packet_Get with a checksum.
+ *
+ *  @return void
+ */
+static void Time(const char *name, const TPacketChecksum checksum)
+{
+  struct timespec start, end;
+  double put = 0, get = 0, ns;
+  unsigned run, i, nbFound = 0;
+
+  Packet_SetChecksum(checksum);
+  for (StreamSize = 0; StreamSize < NB_PACKETS * PACKET_NB_BYTES; StreamSize += PACKET_NB_BYTES)
+    MakePacket(&Stream[StreamSize], checksum);
+  for (run = 0; run < NB_RUNS; run++)
+  {
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < NB_PACKETS; i++)
+      Packet_Put(Stream[i * PACKET_NB_BYTES], i, i >> 8, run);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    ns = ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / NB_PACKETS;
+    if (run == 0 || ns < put)
+      put = ns;
+
+    StreamIndex = 0;
+    nbFound = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while (StreamIndex < StreamSize)
+      nbFound += Packet_Get();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    ns = ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / NB_PACKETS;
+    if (run == 0 || ns < get)
+      get = ns;
+  }
+  printf("%-6s Packet_Put %6.2f ns/packet  Packet_Get %6.2f ns/packet  (%u of %u packets found)\n",
+         name, put, get, nbFound, NB_PACKETS);
+}
+
+/*! @brief Counts the errors of a few bits that a checksum lets through.
+ *
+ *  @param checksum The checksum.
+ *  @param missed The number of undetected errors by number of bits flipped, 1 to 3, filled in.
+ *  @param tried The number of errors tried by number of bits, filled in.
+ *  @return void
+ */
+static void FewBits(const TPacketChecksum checksum, unsigned long missed[4], unsigned long tried[4])
+{
+  uint8_t bytes[PACKET_NB_BYTES];
+  unsigned p, a, b, c;
+
+  memset(missed, 0, 4 * sizeof(missed[0]));
+  memset(tried, 0, 4 * sizeof(tried[0]));
+  for (p = 0; p < NB_ERROR_PACKETS; p++)
+  {
+    MakePacket(bytes, checksum);
+    for (a = 0; a < NB_BITS; a++)
+    {
+      Flip(bytes, a);
+      tried[1]++;
+      missed[1] += Passes(bytes, checksum);
+      for (b = a + 1; b < NB_BITS; b++)
+      {
+        Flip(bytes, b);
+        tried[2]++;
+        missed[2] += Passes(bytes, checksum);
+        for (c = b + 1; c < NB_BITS; c++)
+        {
+          Flip(bytes, c);
+          tried[3]++;
+          missed[3] += Passes(bytes, checksum);
+          Flip(bytes, c);
+        }
+        Flip(bytes, b);
+      }
+      Flip(bytes, a);
+    }
+  }
+}
+
+/*! @brief Counts the bursts of 2 to MAX_BURST bits that a checksum lets through.
+ *
+ *  @return unsigned long - The number of undetected bursts, *tried is set to the number tried.
+ */
+static unsigned long Bursts(const TPacketChecksum checksum, unsigned long *tried)
+{
+  uint8_t bytes[PACKET_NB_BYTES], corrupted[PACKET_NB_BYTES];
+  unsigned long missed = 0;
+  unsigned p, length, first, inside, i;
+
+  *tried = 0;
+  for (p = 0; p < NB_ERROR_PACKETS; p++)
+  {
+    MakePacket(bytes, checksum);
+    for (length = 2; length <= MAX_BURST; length++)
+      for (first = 0; first + length <= NB_BITS; first++)
+        for (inside = 0; inside < (1u << (length - 2)); inside++)
+        {
+          memcpy(corrupted, bytes, sizeof(bytes));
+          Flip(corrupted, first);
+          Flip(corrupted, first + length - 1);
+          for (i = 0; i < length - 2; i++)
+            if (inside & (1u << i))
+              Flip(corrupted, first + 1 + i);
+          (*tried)++;
+          missed += Passes(corrupted, checksum);
+        }
+  }
+  return missed;
+}
+
+/*! @brief Counts the random errors of 4 or more bits that a checksum lets through.
+ *
+ *  @return unsigned long - The number of undetected errors out of NB_RANDOM_ERRORS.
+ */
+static unsigned long RandomErrors(const TPacketChecksum checksum)
+{
+  uint8_t bytes[PACKET_NB_BYTES];
+  unsigned long missed = 0;
+  unsigned long n;
+
+  for (n = 0; n < NB_RANDOM_ERRORS; n++)
+  {
+    uint64_t flipped = 0;
+    unsigned nbBits = 4 + rand() % 8, bit;
+
+    MakePacket(bytes, checksum);
+    /*!distinct bits, a bit flipped twice would be no error at all*/
+    while (__builtin_popcountll(flipped) < nbBits)
+    {
+      bit = rand() % NB_BITS;
+      if (!(flipped & (1ull << bit)))
+      {
+        flipped |= 1ull << bit;
+        Flip(bytes, bit);
+      }
+    }
+    missed += Passes(bytes, checksum);
+  }
+  return missed;
+}
+
+/*! @brief Prints how many corrupted packets a checksum lets through.
+ *
+ *  @return int - Non-zero if it lets through an error it is meant to catch.
+ */
+static int Errors(const char *name, const TPacketChecksum checksum)
+{
+  unsigned long missed[4], tried[4], missedBursts, triedBursts, missedRandom;
+  unsigned k;
+
+  srand(2);
+  FewBits(checksum, missed, tried);
+  missedBursts = Bursts(checksum, &triedBursts);
+  missedRandom = RandomErrors(checksum);
+  printf("%-6s", name);
+  for (k = 1; k <= 3; k++)
+    printf(" %u-bit %lu/%lu missed (%.3f%%) ", k, missed[k], tried[k], 100.0 * missed[k] / tried[k]);
+  printf("\n       bursts <= %u bits %lu/%lu missed (%.3f%%)  random >= 4 bits %lu/%lu missed (%.3f%%)\n",
+         MAX_BURST, missedBursts, triedBursts, 100.0 * missedBursts / triedBursts,
+         missedRandom, (unsigned long)NB_RANDOM_ERRORS, 100.0 * missedRandom / NB_RANDOM_ERRORS);
+  return missed[1] || missed[2] || missed[3] || missedBursts;
+}
+
+int main(void)
+{
+  unsigned i;
+  int failed;
+
+  Stream = malloc(NB_PACKETS * PACKET_NB_BYTES);
+  if (!Stream || !Packet_Init(115200, 60000000))
+    return 1;
+  for (i = 0; i < 256; i++)
+    if (CRC_Table8[i] != BitwiseCRC(i))
+    {
+      printf("CRC_Table8[0x%02X] is 0x%02X, should be 0x%02X\n", i, CRC_Table8[i], BitwiseCRC(i));
+      return 1;
+    }
+  printf("CRC_Table8 matches the bitwise CRC-8\n");
+
+  srand(1);
+  Time("xor", PACKET_CHECKSUM_XOR);
+  Time("crc-8", PACKET_CHECKSUM_CRC8);
+
+  (void)Errors("xor", PACKET_CHECKSUM_XOR);
+  failed = Errors("crc-8", PACKET_CHECKSUM_CRC8);
+  if (failed)
+    printf("the CRC-8 let through an error it should catch\n");
+  return failed;
+}
+
+/* END ChecksumBench */
+/*!
+** @}
+*/
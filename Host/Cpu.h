@@ -0,0 +1,21 @@
+/*! @file
+ *
+ *  @brief Host stand-in for the Processor Expert CPU header.
+ *
+ *  @author Liang Wang
+ *  @date 2016-07-20
+ */
+
+#ifndef CPU_H
+#define CPU_H
+
+#include "PE_Types.h"
+#include "MK70F12.h"
+
+// Bus clock of the TWR-K70F120M, the simulated UART works out its baud rate from it
+#define CPU_BUS_CLK_HZ 60000000u
+
+// Interrupt service routines are called as ordinary functions by HostUART_Service
+#define interrupt
+
+#endif
@@ -0,0 +1,143 @@
+/*! @file
+ *
+ *  @brief FIFO benchmark: times moving bytes through a TFIFO one at a time and a block at a time.
+ *
+ *  FIFO.c is built unchanged. Blocks of a few sizes are put into a FIFO and got out again, either with
+ *  FIFO_Put and FIFO_Get in a loop or with one FIFO_PutBlock and one FIFO_GetBlock. Every byte got out is
+ *  checked. The FIFO starts one byte in, so blocks straddle the end of the buffer now and then and the
+ *  two-part copy is timed too; the share of blocks that wrapped is printed.
+ *
+ *  EnterCritical and ExitCritical only count here, the number of critical sections per byte is printed
+ *  as well, since on the tower each one masks every interrupt.
+ *
+ *  Build and run from the top of the repository:
+ *    gcc -std=gnu99 -O2 -DHOST_CRITICAL_LOCK -IHost -ISources -o fifobench Host/FIFOBench.c Sources/FIFO.c
+ *    ./fifobench
+ *
+ *  @author Liang Wang
+ *  @date 2016-08-15
+ */
+/*!
+**  @addtogroup FIFOBench_module FIFOBench module documentation
+**  @{
+*/
+/* MODULE FIFOBench */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "FIFO.h"
+
+#define FIFO_SIZE 256                                 /*!<small, so blocks straddle its end often*/
+#define NB_BYTES 20000000                             /*!<bytes moved for each block size*/
+#define NB_RUNS 5
+
+static const uint16_t BlockSizes[] = {1, 5, 16, 64, 200};
+
+static TFIFO FIFO;
+FIFO_BUFFER(Buffer, FIFO_SIZE);
+static unsigned long NbCritical;                      /*!<critical sections taken*/
+
+void HostCritical_Enter(void)
+{
+  NbCritical++;
+  __asm__ __volatile__("" ::: "memory");
+}
+
+void HostCritical_Exit(void)
+{
+  __asm__ __volatile__("" ::: "memory");
+}
+
+/*! @brief Moves NB_BYTES bytes through the FIFO in blocks.
+ *
+ *  @param size The number of bytes in a block.
+ *  @param block Non-zero to use FIFO_PutBlock and FIFO_GetBlock, zero for FIFO_Put and FIFO_Get.
+ *  @param nbWrapped Set to the number of blocks that straddled the end of the buffer.
+ *  @return unsigned long - The number of blocks that came out wrong.
+ */
+static unsigned long Move(const uint16_t size, const int block, unsigned long *nbWrapped)
+{
+  uint8_t in[FIFO_SIZE], out[FIFO_SIZE];
+  unsigned long n, nbErrors = 0;
+  uint16_t i;
+
+  *nbWrapped = 0;
+  for (n = 0; n < NB_BYTES; n += size)
+  {
+    for (i = 0; i < size; i++)
+      in[i] = n + i;
+    if (FIFO.End + size > FIFO_SIZE)
+      (*nbWrapped)++;
+    if (block)
+    {
+      FIFO_PutBlock(&FIFO, in, size);
+      FIFO_GetBlock(&FIFO, out, size);
+    }
+    else
+    {
+      for (i = 0; i < size; i++)
+        FIFO_Put(&FIFO, in[i]);
+      for (i = 0; i < size; i++)
+        FIFO_Get(&FIFO, &out[i]);
+    }
+    if (memcmp(in, out, size))
+      nbErrors++;
+  }
+  return nbErrors;
+}
+
+/*! @brief Times one way of moving blocks of one size and prints it.
+ *
+ *  @return double - The best ns per byte.
+ */
+static double Time(const uint16_t size, const int block)
+{
+  struct timespec start, end;
+  double best = 0, ns;
+  unsigned long nbErrors = 0, nbWrapped = 0, nbCritical = 0;
+  unsigned run;
+  uint8_t first;
+
+  for (run = 0; run < NB_RUNS; run++)
+  {
+    FIFO_Init(&FIFO, Buffer, FIFO_SIZE);
+    /*!start one byte in, so that blocks of a size dividing FIFO_SIZE straddle its end too*/
+    FIFO_Put(&FIFO, 0);
+    FIFO_Get(&FIFO, &first);
+    NbCritical = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    nbErrors += Move(size, block, &nbWrapped);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    nbCritical = NbCritical;
+    ns = ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / NB_BYTES;
+    if (run == 0 || ns < best)
+      best = ns;
+  }
+  printf("%-6s %3u bytes  %6.2f ns/byte  %5.2f critical sections/byte  %5.1f%% of blocks wrapped%s\n",
+         block ? "block" : "byte", size, best, (double)nbCritical / NB_BYTES,
+         100.0 * nbWrapped / ((NB_BYTES + size - 1) / size), nbErrors ? "  BYTES CAME OUT WRONG" : "");
+  return nbErrors ? -1 : best;
+}
+
+int main(void)
+{
+  unsigned i;
+  int failed = 0;
+
+  for (i = 0; i < sizeof(BlockSizes) / sizeof(BlockSizes[0]); i++)
+  {
+    double perByte = Time(BlockSizes[i], 0);
+    double perBlock = Time(BlockSizes[i], 1);
+
+    if (perByte < 0 || perBlock < 0)
+      failed = 1;
+    else
+      printf("       %3u bytes  per block takes %.0f%% of the per byte time\n", BlockSizes[i], 100 * perBlock / perByte);
+  }
+  return failed;
+}
+
+/* END FIFOBench */
+/*!
+** @}
+*/
@@ -0,0 +1,160 @@
+/*! @file
+ *
+ *  @brief FIFO stress test: a producer and a consumer thread hammer a FIFO and every byte is checked.
+ *
+ *  The producer puts a pseudo-random byte sequence into the FIFO as fast as it will take it, the consumer
+ *  gets them out and regenerates the sequence to check each one, so a byte lost, repeated, reordered or
+ *  torn shows up as a mismatch. Two FIFOs are run the same way and their rates printed:
+ *    spsc     - a FIFO_DEFINE FIFO, lock-free, as RxFIFO is
+ *    locked   - the TFIFO with FIFO_Put and FIFO_Get, EnterCritical is a mutex shared by both threads
+ *
+ *  A thread that finds the FIFO full or empty yields, so the test also runs on a single core, where the
+ *  threads only meet when one is preempted, which is the interrupt case.
+ *
+ *  The program exits with 1 if any byte does not arrive in order.
+ *
+ *  Build and run from the top of the repository:
+ *    gcc -std=gnu99 -O2 -pthread -DHOST_CRITICAL_LOCK -IHost -ISources -o fifostress Host/FIFOStress.c Sources/FIFO.c
+ *    ./fifostress [megabytes]
+ *
+ *  @author Liang Wang
+ *  @date 2016-08-15
+ */
+/*!
+**  @addtogroup FIFOStress_module FIFOStress module documentation
+**  @{
+*/
+/* MODULE FIFOStress */
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "FIFO.h"
+
+#define FIFO_SIZE 256                                 /*!<small, so the FIFO wraps and fills often*/
+
+FIFO_DEFINE(StressFIFO, uint8_t, FIFO_SIZE)
+
+static TStressFIFO SPSC;
+static TFIFO Locked;
+FIFO_BUFFER(LockedBuffer, FIFO_SIZE);
+static pthread_mutex_t Critical = PTHREAD_MUTEX_INITIALIZER;
+static unsigned long NbBytes;                         /*!<bytes each run sends*/
+static int UseSPSC;                                   /*!<which FIFO the threads use*/
+static unsigned long NbErrors, FirstError;
+
+void HostCritical_Enter(void)
+{
+  pthread_mutex_lock(&Critical);
+}
+
+void HostCritical_Exit(void)
+{
+  pthread_mutex_unlock(&Critical);
+}
+
+/*! @brief Steps the byte sequence both threads generate.
+ *
+ *  @return uint8_t - The next byte.
+ */
+static uint8_t Next(uint32_t *state)
+{
+  *state = *state * 1103515245u + 12345u;
+  return *state >> 16;
+}
+
+/*! @brief Puts the whole sequence into the FIFO, giving way to the consumer while it is full.
+ *
+ */
+static void *Producer(void *unused)
+{
+  uint32_t state = 1;
+  unsigned long i;
+
+  (void)unused;
+  for (i = 0; i < NbBytes; i++)
+  {
+    uint8_t data = Next(&state);
+
+    if (UseSPSC)
+      while (!StressFIFO_Put(&SPSC, &data))
+        sched_yield();
+    else
+      while (!FIFO_Put(&Locked, data))
+        sched_yield();
+  }
+  return NULL;
+}
+
+/*! @brief Gets the whole sequence out of the FIFO and checks every byte.
+ *
+ */
+static void *Consumer(void *unused)
+{
+  uint32_t state = 1;
+  unsigned long i;
+
+  (void)unused;
+  for (i = 0; i < NbBytes; i++)
+  {
+    uint8_t data;
+
+    if (UseSPSC)
+      while (!StressFIFO_Get(&SPSC, &data))
+        sched_yield();
+    else
+      while (!FIFO_Get(&Locked, &data))
+        sched_yield();
+    if (data != Next(&state) && NbErrors++ == 0)
+      FirstError = i;
+  }
+  return NULL;
+}
+
+/*! @brief Runs the producer and the consumer on one FIFO and prints the rate.
+ *
+ *  @return int - Non-zero if a byte did not arrive in order.
+ */
+static int Run(const char *name, const int spsc)
+{
+  struct timespec start, end;
+  pthread_t producer, consumer;
+  double seconds;
+
+  UseSPSC = spsc;
+  StressFIFO_Init(&SPSC);
+  FIFO_Init(&Locked, LockedBuffer, FIFO_SIZE);
+  NbErrors = 0;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  if (pthread_create(&consumer, NULL, Consumer, NULL) || pthread_create(&producer, NULL, Producer, NULL))
+  {
+    perror("pthread_create");
+    exit(1);
+  }
+  pthread_join(producer, NULL);
+  pthread_join(consumer, NULL);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+  printf("%-8s %lu bytes in %.3f s, %8.2f Mbytes/s, ", name, NbBytes, seconds, NbBytes / seconds / 1e6);
+  if (NbErrors)
+    printf("%lu bytes out of order, the first at %lu\n", NbErrors, FirstError);
+  else
+    printf("all in order\n");
+  return NbErrors != 0;
+}
+
+int main(int argc, char *argv[])
+{
+  int failed;
+
+  NbBytes = ((argc > 1) ? strtoul(argv[1], NULL, 0) : 64) * 1000000ul;
+  failed = Run("spsc", 1);
+  failed |= Run("locked", 0);
+  return failed;
+}
+
+/* END FIFOStress */
+/*!
+** @}
+*/
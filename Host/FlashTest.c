@@ -0,0 +1,414 @@
+/*! @file
+ *
+ *  @brief Flash test: the log Flash.c keeps the data storage in is run on a simulated FTFE and checked.
+ *
+ *  Every write is also made to a copy of the data storage in RAM, and what Flash.c reads back has to match
+ *  it, both straight away and after Flash_Init has replayed the log as at a boot. The tests are:
+ *    legacy   - the data storage left in the phrase at FLASH_DATA_START, from before the log, is carried over
+ *    replay   - settings written and read back across boots, compacting through many generations
+ *    random   - random writes, erases and boots
+ *    torn     - a record cut short with some of its bits programmed, so it fails its CRC at the next boot
+ *    boot     - a program cut short before any bit took, so the end of the log reads erased at the next boot
+ *    errors   - commands failing with ACCERR, FPVIOL and MGSTAT0, which must not be taken as written
+ *    offsets  - writes to addresses outside the data storage, which must be refused and change nothing
+ *  In every test no phrase may be programmed again without its sector being erased in between.
+ *
+ *  The program exits with 1 if any check fails.
+ *
+ *  Build and run from the top of the repository:
+ *    gcc -std=gnu99 -O2 -IHost -ISources -o flashtest Host/FlashTest.c Host/HostFTFE.c Sources/Flash.c Sources/CRC.c
+ *    ./flashtest
+ *
+ *  @author Liang Wang
+ *  @date 2016-08-18
+ */
+/*!
+**  @addtogroup FlashTest_module FlashTest module documentation
+**  @{
+*/
+/* MODULE FlashTest */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Flash.h"
+#include "HostFTFE.h"
+
+#define LOG_SECTOR_SIZE 0x1000                        /*!<as in Flash.c*/
+#define LOG_NB_PHRASES (LOG_SECTOR_SIZE / FLASH_PHRASE_SIZE)
+
+static uint8_t Model[FLASH_DATA_SIZE];                /*!<what the data storage should hold*/
+static volatile uint16_t *NvNumber, *NvMode;          /*!<two settings, as the tower allocates them*/
+static unsigned long NbErrors;                        /*!<checks failed in the running test*/
+
+/*! @brief Counts and prints a failed check.
+ *
+ *  @return BOOL - The condition.
+ */
+static BOOL Expect(const BOOL condition, const char *what)
+{
+  if (!condition)
+  {
+    printf("  FAILED: %s\n", what);
+    NbErrors++;
+  }
+  return condition;
+}
+
+/*! @brief Checks the data storage read back from Flash.c against the model.
+ *
+ *  @return BOOL - TRUE if they match.
+ */
+static BOOL Check(const char *what)
+{
+  uint8_t data[FLASH_DATA_SIZE];
+
+  return Expect(Flash_ReadBlock(0, data, FLASH_DATA_SIZE) && !memcmp(data, Model, FLASH_DATA_SIZE), what);
+}
+
+/*! @brief Boots: Flash_Init replays the log, then the data storage is checked.
+ *
+ *  @return BOOL - TRUE if the data storage came back.
+ */
+static BOOL Boot(const char *what)
+{
+  return Expect(Flash_Init(), "Flash_Init") && Check(what);
+}
+
+/*! @brief Starts a test on erased flash, with an erased data storage.
+ *
+ */
+static void Start(void)
+{
+  if (!HostFTFE_Init())
+  {
+    printf("the flash sectors could not be mapped at 0x%lx\n", (unsigned long)FLASH_DATA_START);
+    exit(1);
+  }
+  memset(Model, 0xFF, sizeof(Model));
+  NbErrors = 0;
+}
+
+/*! @brief Prints the result of a test and checks no phrase was programmed twice.
+ *
+ *  @return int - Non-zero if a check failed.
+ */
+static int Finish(const char *name)
+{
+  Expect(HostFTFE_Counts.reprograms == 0, "a phrase was programmed again without an erase");
+  printf("%-8s erases %6lu programs %7lu, %s\n", name, (unsigned long)HostFTFE_Counts.erases,
+         (unsigned long)HostFTFE_Counts.programs, NbErrors ? "FAILED" : "ok");
+  return NbErrors != 0;
+}
+
+/*! @brief Finds the log sector with the newest header, as Flash_Init does.
+ *
+ *  @param generation Where its generation is put.
+ *  @return uint8_t* - The sector, NULL if neither has a header.
+ */
+static uint8_t *ActiveSector(uint32_t *generation)
+{
+  uint8_t *active = NULL, *sector;
+  uint32_t g;
+  int i;
+
+  for (i = 0; i < 2; i++)
+  {
+    sector = (uint8_t*)(FLASH_DATA_START + i * LOG_SECTOR_SIZE);
+    if (sector[0] != 'L' || sector[1] != 'O' || sector[2] != 'G')
+      continue;
+    g = sector[3] | sector[4] << 8 | sector[5] << 16 | (uint32_t)sector[6] << 24;
+    if (!active || g > *generation)
+    {
+      active = sector;
+      *generation = g;
+    }
+  }
+  return active;
+}
+
+/*! @brief Finds the end of the log: the first erased phrase of the active sector.
+ *
+ *  @return uint8_t* - The phrase, NULL if the sector is full.
+ */
+static uint8_t *LogEnd(void)
+{
+  uint32_t generation;
+  uint8_t *sector = ActiveSector(&generation), *phrase;
+  int i, j;
+
+  for (i = 1; sector && i < LOG_NB_PHRASES; i++)
+  {
+    phrase = sector + i * FLASH_PHRASE_SIZE;
+    for (j = 0; j < FLASH_PHRASE_SIZE && phrase[j] == 0xFF; j++)
+      ;
+    if (j == FLASH_PHRASE_SIZE)
+      return phrase;
+  }
+  return NULL;
+}
+
+/*! @brief Writes a setting, in flash and in the model.
+ *
+ *  @return BOOL - What the write returned.
+ */
+static BOOL WriteSetting(volatile uint16_t *setting, const uint16_t value)
+{
+  uint32_t offset = (uintptr_t)setting - FLASH_DATA_START;
+  BOOL written = Flash_Write16(setting, value);
+
+  if (written)
+  {
+    Model[offset] = value & 0xFF;
+    Model[offset + 1] = value >> 8;
+  }
+  return written;
+}
+
+/*! @brief The data storage of a tower from before the log is carried over at its first boot.
+ *
+ *  @return int - Non-zero if a check failed.
+ */
+static int Legacy(void)
+{
+  /*!tower number 6928 and mode 1, in the phrase at FLASH_DATA_START*/
+  const uint8_t legacy[FLASH_DATA_SIZE] = {0x10, 0x1B, 0x01, 0x00, 0xFF, 0xFF, 0xFF, 0xFF};
+  uint32_t generation, erases;
+
+  Start();
+  memcpy((void*)FLASH_DATA_START, legacy, sizeof(legacy));
+  memcpy(Model, legacy, sizeof(legacy));
+  Boot("the legacy data storage is carried over");
+  Expect(Flash_Read16(NvNumber) == 6928 && Flash_Read16(NvMode) == 1, "the legacy settings read back");
+  Expect(ActiveSector(&generation) == (uint8_t*)(FLASH_DATA_START + LOG_SECTOR_SIZE) && generation == 1,
+         "the log starts in the second sector");
+  erases = HostFTFE_Counts.erases;
+  Boot("the carried over data storage comes back at the next boot");
+  Expect(HostFTFE_Counts.erases == erases, "it is only carried over once");
+  WriteSetting(NvMode, 0);
+  Boot("a write after the carry over comes back");
+  return Finish("legacy");
+}
+
+/*! @brief Settings written one after the other come back at every boot, through many compactions.
+ *
+ *  @return int - Non-zero if a check failed.
+ */
+static int Replay(void)
+{
+  uint32_t generation;
+  int i;
+
+  Start();
+  Boot("an erased data storage");
+  for (i = 0; i < 10000; i++)
+  {
+    if (!Expect(WriteSetting((i & 1) ? NvMode : NvNumber, i * 7 + 1), "a setting is written"))
+      break;
+    if (i % 997 == 0 && !Boot("the settings come back at a boot"))
+      break;
+  }
+  Boot("the settings come back at the last boot");
+  Expect(ActiveSector(&generation) && generation > 10, "the log was compacted many times");
+  return Finish("replay");
+}
+
+/*! @brief Random writes, erases and boots.
+ *
+ *  @return int - Non-zero if a check failed.
+ */
+static int Random(void)
+{
+  uint8_t data[FLASH_DATA_SIZE];
+  uint16_t offset, nbBytes, i;
+  int step, choice;
+
+  Start();
+  Boot("an erased data storage");
+  srand(5);
+  for (step = 0; step < 100000 && !NbErrors; step++)
+  {
+    choice = rand() % 10;
+    if (choice < 4)
+    {
+      offset = rand() % FLASH_DATA_SIZE;
+      nbBytes = 1 + rand() % (FLASH_DATA_SIZE - offset);
+      for (i = 0; i < nbBytes; i++)
+        data[i] = (rand() % 4) ? rand() : 0xFF;
+      if (Expect(Flash_WriteBlock(offset, data, nbBytes), "a block is written"))
+        memcpy(&Model[offset], data, nbBytes);
+    }
+    else if (choice < 8)
+    {
+      offset = rand() % FLASH_DATA_SIZE;
+      data[0] = rand();
+      if (Expect(Flash_Write8((volatile uint8_t*)(uintptr_t)(FLASH_DATA_START + offset), data[0]), "a byte is written"))
+        Model[offset] = data[0];
+    }
+    else if (choice < 9)
+    {
+      if (Expect(Flash_Erase(), "the data storage is erased"))
+        memset(Model, 0xFF, sizeof(Model));
+    }
+    else
+      Boot("the data storage comes back at a boot");
+    Check("the data storage reads back after each step");
+  }
+  return Finish("random");
+}
+
+/*! @brief A record cut short after some of its bits took fails its CRC and is skipped at the next boot.
+ *
+ *  @return int - Non-zero if a check failed.
+ */
+static int TornRecord(void)
+{
+  uint8_t *end;
+
+  Start();
+  Boot("an erased data storage");
+  WriteSetting(NvNumber, 6928);
+  WriteSetting(NvMode, 1);
+  WriteSetting(NvNumber, 1234);
+  if (Expect((end = LogEnd()) != NULL, "the log has room"))
+  {
+    /*!offset 0, 2 bytes, only the first of them and no CRC programmed*/
+    end[0] = 0x00;
+    end[1] = 0x02;
+    end[2] = 0x55;
+  }
+  Boot("the torn record is skipped");
+  WriteSetting(NvNumber, 4321);
+  Check("a write after the torn record reads back");
+  Boot("a write after the torn record comes back");
+  return Finish("torn");
+}
+
+/*! @brief A program cut short before any of its bits took leaves the end of the log reading erased.
+ *
+ *  The first write after the boot must not program that phrase again, and boots without writes cost nothing.
+ *  @return int - Non-zero if a check failed.
+ */
+static int BootAfterReset(void)
+{
+  uint32_t erases, programs;
+  int i;
+
+  Start();
+  Boot("an erased data storage");
+  for (i = 0; i < 20; i++)
+    WriteSetting(NvNumber, i);
+  HostFTFE_Tear((uintptr_t)LogEnd());
+  Boot("the log ends at the torn phrase");
+  erases = HostFTFE_Counts.erases;
+  WriteSetting(NvMode, 5);
+  Expect(HostFTFE_Counts.erases == erases + 1, "the first write after a boot compacts");
+  WriteSetting(NvNumber, 77);
+  Expect(HostFTFE_Counts.erases == erases + 1, "the next one appends");
+  Boot("both writes come back");
+  erases = HostFTFE_Counts.erases;
+  programs = HostFTFE_Counts.programs;
+  for (i = 0; i < 100; i++)
+    Flash_Init();
+  Expect(HostFTFE_Counts.erases == erases && HostFTFE_Counts.programs == programs, "boots without writes cost nothing");
+  return Finish("boot");
+}
+
+/*! @brief A command that fails is reported, changes nothing that reads back, and does not stop the next one.
+ *
+ *  @return int - Non-zero if a check failed.
+ */
+static int Errors(void)
+{
+  uint32_t erases;
+
+  Start();
+  Boot("an erased data storage");
+  WriteSetting(NvNumber, 1);
+
+  HostFTFE_Fail(FTFE_FSTAT_ACCERR_MASK);
+  Expect(!WriteSetting(NvNumber, 2), "a write fails on an access error");
+  Check("the failed write does not read back");
+  Expect(WriteSetting(NvNumber, 3), "the next write clears the access error");
+
+  HostFTFE_Fail(FTFE_FSTAT_FPVIOL_MASK);
+  Expect(!WriteSetting(NvMode, 4), "a write fails on a protection violation");
+  Check("the failed write does not read back");
+  Expect(WriteSetting(NvMode, 5), "the next write clears the protection violation on its own");
+  Boot("the writes that did not fail come back");
+
+  WriteSetting(NvNumber, 6);
+  HostFTFE_Fail(FTFE_FSTAT_MGSTAT0_MASK);
+  Expect(!WriteSetting(NvNumber, 7), "a write fails when its program fails to verify");
+  Check("the failed write does not read back");
+  erases = HostFTFE_Counts.erases;
+  Expect(WriteSetting(NvNumber, 8), "the next write works");
+  Expect(HostFTFE_Counts.erases == erases + 1, "it compacts rather than append after the half programmed record");
+  Boot("the writes that did not fail come back");
+
+  /*!the first write after a boot compacts, and its erase fails*/
+  HostFTFE_Fail(FTFE_FSTAT_MGSTAT0_MASK);
+  Expect(!WriteSetting(NvMode, 9), "a write fails when the erase of its compaction fails to verify");
+  Check("the failed write does not read back");
+  Boot("the active sector is still the one from before the failed compaction");
+  Expect(WriteSetting(NvMode, 10), "the next write works");
+  Boot("the writes that did not fail come back");
+  return Finish("errors");
+}
+
+/*! @brief Writes that go outside the data storage are refused, however their offset wraps.
+ *
+ *  The offset is worked out from a 32-bit address, so an address far outside the data storage can land
+ *  inside it when cut to 16 bits, and offset + nbBytes can wrap past 0.
+ *  @return int - Non-zero if a check failed.
+ */
+static int Offsets(void)
+{
+  const uint8_t data[FLASH_DATA_SIZE] = {0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42};
+  uint32_t programs;
+
+  Start();
+  Boot("an erased data storage");
+  WriteSetting(NvNumber, 6928);
+  programs = HostFTFE_Counts.programs;
+  /*!0x10003 and 0xFFFF0003 are 3 in 16 bits*/
+  Expect(!Flash_Write8((volatile uint8_t*)0x90003, 0x42), "a byte at 0x90003 is refused");
+  Expect(!Flash_Write8((volatile uint8_t*)0x70003, 0x42), "a byte at 0x70003 is refused");
+  Expect(!Flash_Write16((volatile uint16_t*)0x90002, 0x4242), "a half-word at 0x90002 is refused");
+  Expect(!Flash_Write32((volatile uint32_t*)0x90004, 0x42424242), "a word at 0x90004 is refused");
+  /*!below FLASH_DATA_START the offset wraps to near 2^32, and 0xFFFFFFFC + 4 wraps to 0*/
+  Expect(!Flash_Write8((volatile uint8_t*)(FLASH_DATA_START - 1), 0x42), "a byte just below the data storage is refused");
+  Expect(!Flash_Write32((volatile uint32_t*)(FLASH_DATA_START - 4), 0x42424242), "a word just below the data storage is refused");
+  /*!past FLASH_DATA_END*/
+  Expect(!Flash_Write8((volatile uint8_t*)(FLASH_DATA_END + 1), 0x42), "a byte just past the data storage is refused");
+  Expect(!Flash_Write32((volatile uint32_t*)(FLASH_DATA_END + 1), 0x42424242), "a word just past the data storage is refused");
+  Expect(!Flash_WriteBlock(FLASH_DATA_SIZE - 2, data, 3), "a block running past the data storage is refused");
+  Expect(!Flash_WriteBlock(0xFFFF, data, 2), "a block starting far past the data storage is refused");
+  Expect(HostFTFE_Counts.programs == programs, "the refused writes program nothing");
+  Check("the refused writes do not read back");
+  Boot("the refused writes do not come back");
+  Expect(Flash_Write8((volatile uint8_t*)(FLASH_DATA_START + 3), 0x42), "a byte inside the data storage is written");
+  Model[3] = 0x42;
+  Check("the byte inside the data storage reads back");
+  return Finish("offsets");
+}
+
+int main(void)
+{
+  int failed;
+
+  Flash_AllocateVar((volatile void**)&NvNumber, sizeof(*NvNumber));
+  Flash_AllocateVar((volatile void**)&NvMode, sizeof(*NvMode));
+  failed = Legacy();
+  failed |= Replay();
+  failed |= Random();
+  failed |= TornRecord();
+  failed |= BootAfterReset();
+  failed |= Errors();
+  failed |= Offsets();
+  return failed;
+}
+
+/* END FlashTest */
+/*!
+** @}
+*/
@@ -0,0 +1,168 @@
+/*! @file
+ *
+ *  @brief Simulated flash memory module (FTFE) for the flash tests.
+ *
+ *  This module backs the log sectors with memory mapped at their tower addresses and carries out the
+ *  commands launched through FTFE_FSTAT.
+ *
+ *  @author Liang Wang
+ *  @date 2016-08-18
+ */
+/*!
+**  @addtogroup HostFTFE_module HostFTFE module documentation
+**  @{
+*/
+/* MODULE HostFTFE */
+#include <string.h>
+#include <sys/mman.h>
+#include "HostFTFE.h"
+#include "Flash.h"
+
+#define SECTOR_SIZE 0x1000                 /*!< the FTFE erases 4 KB sectors*/
+#define NB_SECTORS 2                       /*!< the sectors of the log, the only ones simulated*/
+#define CMD_PROGRAM_PHRASE 0x07
+#define CMD_ERASE_SECTOR 0x09
+#define BUSY_READS 3                       /*!< reads of FSTAT a command keeps CCIF clear for*/
+#define FSTAT_READ 0x100                   /*!< set in FSTAT when it is handed out, cleared by a value written into it*/
+#define FSTAT_ERRORS (FTFE_FSTAT_ACCERR_MASK | FTFE_FSTAT_FPVIOL_MASK)
+
+volatile uint32_t SIM_SCGC3;
+volatile uint8_t FTFE_FCCOB0, FTFE_FCCOB1, FTFE_FCCOB2, FTFE_FCCOB3, FTFE_FCCOB4, FTFE_FCCOB5;
+volatile uint8_t FTFE_FCCOB6, FTFE_FCCOB7, FTFE_FCCOB8, FTFE_FCCOB9, FTFE_FCCOBA, FTFE_FCCOBB;
+
+THostFTFECounts HostFTFE_Counts;
+
+static uint8_t* Memory;                    /*!< the sectors, at FLASH_DATA_START*/
+static volatile uint16_t FSTAT;            /*!< what FTFE_FSTAT points to*/
+static uint8_t Status;                     /*!< the value of the status register*/
+static unsigned Busy;                      /*!< reads left until the running command completes*/
+static uint8_t Failure;                    /*!< the error the next command ends with, 0 for none*/
+static uint32_t Torn;                      /*!< a phrase whose program was cut short, 0 for none*/
+
+BOOL HostFTFE_Init(void)
+{
+  if (!Memory)
+  {
+    void* memory = mmap((void*)FLASH_DATA_START, NB_SECTORS * SECTOR_SIZE, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    /*!the address is only a hint, Flash.c needs the sectors exactly there*/
+    if (memory == MAP_FAILED)
+      return bFALSE;
+    if (memory != (void*)FLASH_DATA_START)
+    {
+      munmap(memory, NB_SECTORS * SECTOR_SIZE);
+      return bFALSE;
+    }
+    Memory = memory;
+  }
+  memset(Memory, 0xFF, NB_SECTORS * SECTOR_SIZE);
+  memset(&HostFTFE_Counts, 0, sizeof(HostFTFE_Counts));
+  Status = FTFE_FSTAT_CCIF_MASK;
+  FSTAT = FSTAT_READ | Status;
+  Busy = 0;
+  Failure = 0;
+  Torn = 0;
+  return bTRUE;
+}
+
+void HostFTFE_Fail(const uint8_t error)
+{
+  Failure = error;
+}
+
+void HostFTFE_Tear(const uint32_t address)
+{
+  Torn = address;
+}
+
+/*! @brief Finds the simulated memory a command acts on.
+ *
+ *  @param address The address loaded into FCCOB1 to FCCOB3.
+ *  @param size The size of the sector or phrase, which the address has to be a multiple of.
+ *  @return uint8_t* - The memory, or NULL if the address is not in the log sectors or not aligned.
+ */
+static uint8_t* Target(const uint32_t address, const uint32_t size)
+{
+  if (address % size != 0 || address < FLASH_DATA_START || address - FLASH_DATA_START >= NB_SECTORS * SECTOR_SIZE)
+    return NULL;
+  return Memory + (address - FLASH_DATA_START);
+}
+
+/*! @brief Carries out the command loaded into the FCCOB registers.
+ *
+ *  @return uint8_t - The error bits it ends with.
+ */
+static uint8_t Run(void)
+{
+  uint32_t address = ((uint32_t)FTFE_FCCOB1 << 16) | ((uint32_t)FTFE_FCCOB2 << 8) | FTFE_FCCOB3;
+  uint8_t phrase[FLASH_PHRASE_SIZE] = {FTFE_FCCOB7, FTFE_FCCOB6, FTFE_FCCOB5, FTFE_FCCOB4,
+                                       FTFE_FCCOBB, FTFE_FCCOBA, FTFE_FCCOB9, FTFE_FCCOB8};
+  uint8_t failure = Failure;
+  uint8_t* target;
+  uint32_t size, i;
+  BOOL erased = bTRUE;
+
+  Failure = 0;
+  if (failure & FSTAT_ERRORS)
+    return failure & FSTAT_ERRORS;
+  switch (FTFE_FCCOB0)
+  {
+    case CMD_ERASE_SECTOR:
+      if (!(target = Target(address, SECTOR_SIZE)))
+        return FTFE_FSTAT_ACCERR_MASK;
+      /*!a failed verify leaves part of the sector as it was*/
+      size = (failure & FTFE_FSTAT_MGSTAT0_MASK) ? SECTOR_SIZE / 2 : SECTOR_SIZE;
+      memset(target, 0xFF, size);
+      if (Torn >= address && Torn < address + size)
+        Torn = 0;
+      HostFTFE_Counts.erases++;
+      break;
+    case CMD_PROGRAM_PHRASE:
+      if (!(target = Target(address, FLASH_PHRASE_SIZE)))
+        return FTFE_FSTAT_ACCERR_MASK;
+      for (i = 0; i < FLASH_PHRASE_SIZE; i++)
+        erased &= (target[i] == 0xFF);
+      if (!erased || address == Torn)
+        HostFTFE_Counts.reprograms++;
+      /*!a program can only clear bits, and a failed verify leaves some of them set*/
+      size = (failure & FTFE_FSTAT_MGSTAT0_MASK) ? FLASH_PHRASE_SIZE / 2 : FLASH_PHRASE_SIZE;
+      for (i = 0; i < size; i++)
+        target[i] &= phrase[i];
+      HostFTFE_Counts.programs++;
+      break;
+    default:
+      return FTFE_FSTAT_ACCERR_MASK;
+  }
+  return failure & FTFE_FSTAT_MGSTAT0_MASK;
+}
+
+/*! @brief Acts on a value written into FTFE_FSTAT.
+ *
+ *  Writing 1 to ACCERR or FPVIOL clears it, writing 1 to CCIF launches the command in the FCCOB registers,
+ *  unless one is still running or an error has not been cleared.
+ *  @param value The value written.
+ */
+static void Write(const uint8_t value)
+{
+  Status &= ~(value & FSTAT_ERRORS);
+  if (!(value & FTFE_FSTAT_CCIF_MASK) || !(Status & FTFE_FSTAT_CCIF_MASK) || (Status & FSTAT_ERRORS))
+    return;
+  Status = Run();
+  Busy = BUSY_READS;
+}
+
+volatile uint16_t* HostFTFE_FSTAT(void)
+{
+  if (!(FSTAT & FSTAT_READ))
+    Write((uint8_t)FSTAT);
+  else if (Busy && --Busy == 0)
+    Status |= FTFE_FSTAT_CCIF_MASK;
+  FSTAT = FSTAT_READ | Status;
+  return &FSTAT;
+}
+
+/* END HostFTFE */
+/*!
+** @}
+*/
@@ -0,0 +1,54 @@
+/*! @file
+ *
+ *  @brief Simulated flash memory module (FTFE) for the flash tests.
+ *
+ *  The two log sectors from FLASH_DATA_START are mapped into the process at their tower addresses, so
+ *  Flash.c reads them as it does on the tower. The erase sector and program phrase commands launched through
+ *  FTFE_FSTAT act on them as the flash does: an erase sets every bit, a program can only clear bits.
+ *  Commands can be made to fail, and a program can be cut short as by a reset.
+ *
+ *  @author Liang Wang
+ *  @date 2016-08-18
+ */
+
+#ifndef HOSTFTFE_H
+#define HOSTFTFE_H
+
+#include "types.h"
+
+/*!
+ * @struct THostFTFECounts
+ */
+typedef struct
+{
+  uint32_t erases;        /*!< Sectors erased. */
+  uint32_t programs;      /*!< Phrases programmed. */
+  uint32_t reprograms;    /*!< Phrases programmed that were not erased, or whose last program was cut short. */
+} THostFTFECounts;
+
+/*! @brief The commands carried out since HostFTFE_Init. */
+extern THostFTFECounts HostFTFE_Counts;
+
+/*! @brief Maps the log sectors at FLASH_DATA_START, erased, and makes the flash ready for a command.
+ *
+ *  @return BOOL - TRUE if the sectors could be mapped at their tower addresses.
+ */
+BOOL HostFTFE_Init(void);
+
+/*! @brief Makes the next command fail.
+ *
+ *  @param error FTFE_FSTAT_ACCERR_MASK or FTFE_FSTAT_FPVIOL_MASK for a command that is refused and changes
+ *         nothing, FTFE_FSTAT_MGSTAT0_MASK for one that stops half way and fails its verify.
+ *  @return void
+ */
+void HostFTFE_Fail(const uint8_t error);
+
+/*! @brief Cuts short a program of a phrase, as a reset would before any of its bits took.
+ *
+ *  The phrase still reads erased, but programming it again counts as a reprogram until its sector is erased.
+ *  @param address The address of the phrase.
+ *  @return void
+ */
+void HostFTFE_Tear(const uint32_t address);
+
+#endif
@@ -0,0 +1,62 @@
+/*! @file
+ *
+ *  @brief Flash data storage in RAM for the virtual tower.
+ *
+ *  This module stands in for Flash.c with the functions protocol.c uses. The FLASH_DATA_SIZE bytes of the
+ *  data storage are kept in RAM, erased to 0xFF at start, so the tower number and mode set from the PC last
+ *  until the virtual tower is stopped.
+ *
+ *  @author Liang Wang
+ *  @date 2016-08-16
+ */
+/*!
+**  @addtogroup HostFlash_module HostFlash module documentation
+**  @{
+*/
+/* MODULE HostFlash */
+#include <string.h>
+#include "Flash.h"
+
+static uint8_t Storage[FLASH_DATA_SIZE] __attribute__ ((aligned (4)));  /*!< the data storage*/
+static uint16_t NextOffset;                           /*!< the first byte not yet allocated*/
+
+
+BOOL Flash_Init(void)
+{
+  memset(Storage, 0xFF, sizeof(Storage));
+  NextOffset = 0;
+  return bTRUE;
+}
+
+
+BOOL Flash_AllocateVar(volatile void** variable, const uint8_t size)
+{
+  /*!aligned to its size, as on the tower*/
+  uint16_t offset = (NextOffset + size - 1) / size * size;
+
+  if ((size != 1 && size != 2 && size != 4) || offset + size > FLASH_DATA_SIZE)
+    return bFALSE;
+  *variable = &Storage[offset];
+  NextOffset = offset + size;
+  return bTRUE;
+}
+
+
+BOOL Flash_Write16(volatile uint16_t* const address, const uint16_t data)
+{
+  if ((uint8_t*)address < Storage || (uint8_t*)address + sizeof(data) > Storage + FLASH_DATA_SIZE)
+    return bFALSE;
+  *address = data;
+  return bTRUE;
+}
+
+
+uint16_t Flash_Read16(volatile uint16_t* const address)
+{
+  return *address;
+}
+
+/* END HostFlash */
+/*!
+** @}
+*/
@@ -0,0 +1,249 @@
+/*! @file
+ *
+ *  @brief Simulated UART2 for the virtual tower.
+ *
+ *  This module backs the UART2 registers with a Linux pseudo-terminal.
+ *
+ *  @author Liang Wang
+ *  @date 2016-07-20
+ */
+/*!
+**  @addtogroup HostUART_module HostUART module documentation
+**  @{
+*/
+/* MODULE HostUART */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "HostUART.h"
+#include "Cpu.h"
+#include "UART.h"
+
+#define BUFFER_SIZE 4096                   /*!< bytes the pty side buffers in each direction*/
+#define BITS_PER_BYTE 10                   /*!< start bit, 8 data bits and a stop bit*/
+#define MAX_ISR_CALLS 64                   /*!< interrupts taken per service call, in case one stays pending*/
+#define CORE_CLK_MHZ 120                   /*!< core clock of the TWR-K70F120M, the cycle counter runs at it*/
+#define NVIC_UART2_BIT (1u << 17)          /*!< UART2 status interrupt, IRQ 49*/
+#define D_IDLE 0xFFFF                      /*!< UART2_D has not been accessed since the last settle*/
+#define D_READ 0x8000                      /*!< set in UART2_D when it is handed out, cleared by a byte written into it*/
+
+volatile uint32_t SIM_SCGC4, SIM_SCGC5;
+volatile uint32_t PORTE_PCR16, PORTE_PCR17;
+volatile uint32_t NVICICPR1, NVICISER1;
+volatile uint8_t UART2_BDH, UART2_BDL, UART2_C1, UART2_C2, UART2_C4, UART2_C5, UART2_MODEM;
+volatile uint8_t UART2_PFIFO, UART2_CFIFO, UART2_SFIFO, UART2_TWFIFO, UART2_RWFIFO, UART2_TCFIFO, UART2_RCFIFO;
+volatile uint32_t DWT_CTRL, SCB_DEMCR;
+
+static int Master = -1;                    /*!< the tower's end of the pty*/
+static int Slave = -1;                     /*!< kept open so the pty stays raw and readable without a client*/
+static char Name[64];                      /*!< the client's end of the pty*/
+
+static uint8_t RxBuffer[BUFFER_SIZE];      /*!< bytes from the client not yet received by the UART*/
+static size_t RxStart, RxNbBytes;
+static uint8_t TxBuffer[BUFFER_SIZE];      /*!< bytes sent by the UART not yet written to the pty*/
+static size_t TxNbBytes;
+
+static uint64_t RxReadyAt;                 /*!< time the next received byte has fully arrived*/
+static uint64_t TxDoneAt;                  /*!< time the last written byte has left the shift register*/
+
+static volatile uint16_t D = D_IDLE;       /*!< what UART2_D points to*/
+static BOOL RxLoaded;                      /*!< a received byte was put in D when it was handed out*/
+
+/*! @brief Reads the monotonic clock.
+ *
+ *  @return uint64_t - Nanoseconds.
+ */
+static uint64_t Now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+uint32_t HostUART_CycleCount(void)
+{
+  /*!host time scaled to the tower's core clock, so that the command counters read alike*/
+  return (uint32_t)(Now() / 1000u * CORE_CLK_MHZ);
+}
+
+/*! @brief Works out how long a byte takes on the line from the baud rate registers.
+ *
+ *  @return uint64_t - Nanoseconds per byte.
+ */
+static uint64_t ByteTime(void)
+{
+  uint32_t divisor = ((((uint32_t)UART2_BDH & UART_BDH_SBR_MASK) << 8 | UART2_BDL) << 5) | (UART2_C4 & UART_C4_BRFA_MASK);
+
+  if (divisor < 32)
+    return 0;
+  /*!baud rate = 2 x clock / divisor*/
+  return (uint64_t)BITS_PER_BYTE * 1000000000u * divisor / (2u * (uint64_t)CPU_BUS_CLK_HZ);
+}
+
+/*! @brief Acts on the last access to UART2_D.
+ *
+ *  A byte written into D is transmitted, a read of a received byte takes it out of the receiver.
+ */
+static void Settle(void)
+{
+  uint64_t now;
+
+  if (D == D_IDLE)
+    return;
+  now = Now();
+  if (!(D & D_READ))
+  {
+    /*!written, only sent if the transmitter is enabled*/
+    if ((UART2_C2 & UART_C2_TE_MASK) && TxNbBytes < BUFFER_SIZE)
+    {
+      TxBuffer[TxNbBytes++] = (uint8_t)D;
+      /*!the byte starts once the one before it is out, or straight away on an idle line*/
+      TxDoneAt = ((TxDoneAt > now) ? TxDoneAt : now) + ByteTime();
+    }
+  }
+  else if (RxLoaded)
+  {
+    RxStart = (RxStart + 1) % BUFFER_SIZE;
+    RxNbBytes--;
+    /*!the bytes of a burst arrive back to back, however late they are read*/
+    RxReadyAt += ByteTime();
+  }
+  D = D_IDLE;
+  RxLoaded = bFALSE;
+}
+
+/*! @brief Checks whether a received byte is waiting in the data register.
+ *
+ *  @param now The current time.
+ *  @return BOOL - TRUE if RDRF is set.
+ */
+static BOOL RxReady(const uint64_t now)
+{
+  return (UART2_C2 & UART_C2_RE_MASK) && RxNbBytes && now >= RxReadyAt;
+}
+
+uint8_t HostUART_S1(void)
+{
+  uint64_t now;
+  uint8_t status = 0;
+
+  Settle();
+  now = Now();
+  /*!the data register is free once the byte before it has moved into the shift register*/
+  if (TxNbBytes < BUFFER_SIZE && (TxDoneAt < now + ByteTime()))
+    status |= UART_S1_TDRE_MASK;
+  if (TxDoneAt <= now)
+    status |= UART_S1_TC_MASK;
+  if (RxReady(now))
+    status |= UART_S1_RDRF_MASK;
+  return status;
+}
+
+volatile uint16_t* HostUART_D(void)
+{
+  Settle();
+  /*!hand out the received byte; writing over it turns the access into a write*/
+  if (RxReady(Now()))
+  {
+    D = D_READ | RxBuffer[RxStart];
+    RxLoaded = bTRUE;
+  }
+  else
+    D = D_READ;
+  return &D;
+}
+
+/*! @brief Checks whether the UART2 interrupt is enabled and one of its enabled flags is set.
+ *
+ *  @return BOOL - TRUE if UART_ISR should be called.
+ */
+static BOOL InterruptPending(void)
+{
+  uint8_t status;
+
+  if (!(NVICISER1 & NVIC_UART2_BIT))
+    return bFALSE;
+  status = HostUART_S1();
+  return ((UART2_C2 & UART_C2_RIE_MASK) && (status & UART_S1_RDRF_MASK))
+      || ((UART2_C2 & UART_C2_TIE_MASK) && (status & UART_S1_TDRE_MASK))
+      || ((UART2_C2 & UART_C2_TCIE_MASK) && (status & UART_S1_TC_MASK));
+}
+
+BOOL HostUART_Open(void)
+{
+  struct termios raw;
+
+  Master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (Master < 0 || grantpt(Master) || unlockpt(Master) || ptsname_r(Master, Name, sizeof(Name)))
+    return bFALSE;
+  Slave = open(Name, O_RDWR | O_NOCTTY);
+  if (Slave < 0 || tcgetattr(Slave, &raw))
+    return bFALSE;
+  /*!no echo or line editing, the client sees exactly the bytes the tower sends*/
+  cfmakeraw(&raw);
+  if (tcsetattr(Slave, TCSANOW, &raw))
+    return bFALSE;
+  return fcntl(Master, F_SETFL, O_NONBLOCK) == 0;
+}
+
+const char* HostUART_Name(void)
+{
+  return Name;
+}
+
+void HostUART_Service(void)
+{
+  struct pollfd pfd;
+  ssize_t nb;
+  size_t end, room;
+  uint64_t now, byteTime, onLine;
+  int i;
+
+  /*!take what the client has written*/
+  end = (RxStart + RxNbBytes) % BUFFER_SIZE;
+  room = (end >= RxStart) ? BUFFER_SIZE - end : RxStart - end;
+  if (RxNbBytes < BUFFER_SIZE && (nb = read(Master, &RxBuffer[end], room)) > 0)
+  {
+    /*!on an idle line the first byte still takes a byte time to arrive*/
+    if (RxNbBytes == 0 && RxReadyAt < Now())
+      RxReadyAt = Now() + ByteTime();
+    RxNbBytes += nb;
+  }
+
+  /*!run the interrupt while it is pending, as the NVIC would*/
+  for (i = 0; i < MAX_ISR_CALLS && InterruptPending(); i++)
+  {
+    UART_ISR();
+    Settle();
+  }
+
+  /*!give the client what has been sent, a byte only once it has fully left the shift register*/
+  now = Now();
+  byteTime = ByteTime();
+  onLine = (TxDoneAt > now && byteTime) ? (TxDoneAt - now + byteTime - 1) / byteTime : 0;
+  if (TxNbBytes > onLine && (nb = write(Master, TxBuffer, TxNbBytes - onLine)) > 0)
+  {
+    memmove(TxBuffer, TxBuffer + nb, TxNbBytes - nb);
+    TxNbBytes -= nb;
+  }
+
+  /*!with nothing in flight, wait for the client instead of spinning*/
+  if (i == 0 && RxNbBytes == 0 && TxNbBytes == 0 && !(UART2_C2 & UART_C2_TIE_MASK))
+  {
+    pfd.fd = Master;
+    pfd.events = POLLIN;
+    (void)poll(&pfd, 1, 1);
+  }
+}
+
+/* END HostUART */
+/*!
+** @}
+*/
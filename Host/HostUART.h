@@ -0,0 +1,38 @@
+/*! @file
+ *
+ *  @brief Simulated UART2 for the virtual tower.
+ *
+ *  The UART2 registers are backed by a Linux pseudo-terminal: what UART.c writes to UART2_D comes out of
+ *  the pty, what a PC client writes into the pty shows up in UART2_D. Both directions are paced at the
+ *  baud rate programmed in BDH, BDL and C4, so a client sees the throughput and latency the real link has.
+ *
+ *  @author Liang Wang
+ *  @date 2016-07-20
+ */
+
+#ifndef HOSTUART_H
+#define HOSTUART_H
+
+#include "types.h"
+
+/*! @brief Opens the pseudo-terminal the PC client connects to.
+ *
+ *  @return BOOL - TRUE if the pty was opened.
+ */
+BOOL HostUART_Open(void);
+
+/*! @brief Gets the name of the device the PC client should open.
+ *
+ *  @return const char* - The pty's slave device, e.g. /dev/pts/3.
+ */
+const char* HostUART_Name(void);
+
+/*! @brief Moves bytes between the pty and the simulated UART, and calls UART_ISR while its interrupt is pending.
+ *
+ *  Waits for up to a millisecond when there is nothing to do, so the main loop does not spin.
+ *  @return void
+ *  @note Assumes that HostUART_Open has been called.
+ */
+void HostUART_Service(void);
+
+#endif
@@ -0,0 +1,130 @@
+/*! @file
+ *
+ *  @brief Host stand-in for the parts of the K70 register header used by UART.c and Flash.c.
+ *
+ *  Plain registers are variables. The UART status register and data register have side effects,
+ *  so they are routed through HostUART.c: see HostUART_S1 and HostUART_D. So is the flash status
+ *  register, which launches commands, through HostFTFE.c: see HostFTFE_FSTAT.
+ *  Of the eDMA modes only the receive one can be built, for RxDMAStress.c, which defines the eDMA
+ *  registers and acts on them itself.
+ *
+ *  @author Liang Wang
+ *  @date 2016-07-20
+ */
+
+#ifndef MK70F12_H
+#define MK70F12_H
+
+#include <stdint.h>
+
+#if UART_TX_DMA
+#error "the host only simulates the receive eDMA channel"
+#endif
+
+/*!
+ * @struct THostDMATCD
+ */
+typedef struct
+{
+  uint32_t SADDR;           /*!< Source address. */
+  int16_t SOFF;             /*!< Added to the source address after each read. */
+  uint16_t ATTR;            /*!< Transfer sizes. */
+  uint32_t NBYTES_MLNO;     /*!< Bytes per request. */
+  uint32_t SLAST;           /*!< Added to the source address at the end of the major loop. */
+  uint32_t DADDR;           /*!< Destination address. */
+  int16_t DOFF;             /*!< Added to the destination address after each write. */
+  uint16_t CITER_ELINKNO;   /*!< Requests left in the major loop. */
+  uint32_t DLAST_SGA;       /*!< Added to the destination address at the end of the major loop. */
+  uint16_t CSR;             /*!< Control and status. */
+  uint16_t BITER_ELINKNO;   /*!< Requests in the major loop, CITER is loaded from it at the end. */
+} THostDMATCD;
+
+extern volatile uint32_t SIM_SCGC4, SIM_SCGC5;
+extern volatile uint32_t PORTE_PCR16, PORTE_PCR17;
+extern volatile uint32_t NVICICPR1, NVICISER1;
+extern volatile uint8_t UART2_BDH, UART2_BDL, UART2_C1, UART2_C2, UART2_C4, UART2_C5, UART2_MODEM;
+extern volatile uint8_t UART2_PFIFO, UART2_CFIFO, UART2_SFIFO, UART2_TWFIFO, UART2_RWFIFO, UART2_TCFIFO, UART2_RCFIFO;
+
+extern volatile uint32_t DWT_CTRL, SCB_DEMCR;
+
+extern volatile uint32_t SIM_SCGC6, SIM_SCGC7;
+extern volatile uint32_t NVICICPR0, NVICISER0;
+extern volatile uint8_t HostDMA_CHCFG[16];
+extern volatile THostDMATCD HostDMA_TCD[16];
+extern volatile uint8_t DMA_SERQ, DMA_CINT;
+
+uint32_t HostUART_CycleCount(void);
+uint8_t HostUART_S1(void);
+volatile uint16_t* HostUART_D(void);
+
+#define UART2_S1 HostUART_S1()
+#define UART2_D  (*HostUART_D())
+#define DWT_CYCCNT HostUART_CycleCount()
+
+#define DMAMUX0_CHCFG(channel)     HostDMA_CHCFG[channel]
+#define DMA_SADDR(channel)         HostDMA_TCD[channel].SADDR
+#define DMA_SOFF(channel)          HostDMA_TCD[channel].SOFF
+#define DMA_ATTR(channel)          HostDMA_TCD[channel].ATTR
+#define DMA_NBYTES_MLNO(channel)   HostDMA_TCD[channel].NBYTES_MLNO
+#define DMA_SLAST(channel)         HostDMA_TCD[channel].SLAST
+#define DMA_DADDR(channel)         HostDMA_TCD[channel].DADDR
+#define DMA_DOFF(channel)          HostDMA_TCD[channel].DOFF
+#define DMA_CITER_ELINKNO(channel) HostDMA_TCD[channel].CITER_ELINKNO
+#define DMA_DLAST_SGA(channel)     HostDMA_TCD[channel].DLAST_SGA
+#define DMA_CSR(channel)           HostDMA_TCD[channel].CSR
+#define DMA_BITER_ELINKNO(channel) HostDMA_TCD[channel].BITER_ELINKNO
+
+extern volatile uint32_t SIM_SCGC3;
+extern volatile uint8_t FTFE_FCCOB0, FTFE_FCCOB1, FTFE_FCCOB2, FTFE_FCCOB3, FTFE_FCCOB4, FTFE_FCCOB5;
+extern volatile uint8_t FTFE_FCCOB6, FTFE_FCCOB7, FTFE_FCCOB8, FTFE_FCCOB9, FTFE_FCCOBA, FTFE_FCCOBB;
+
+volatile uint16_t* HostFTFE_FSTAT(void);
+
+#define FTFE_FSTAT (*HostFTFE_FSTAT())
+
+#define SIM_SCGC3_NFC_MASK             0x100u
+#define FTFE_FSTAT_MGSTAT0_MASK        0x1u
+#define FTFE_FSTAT_FPVIOL_MASK         0x10u
+#define FTFE_FSTAT_ACCERR_MASK         0x20u
+#define FTFE_FSTAT_RDCOLERR_MASK       0x40u
+#define FTFE_FSTAT_CCIF_MASK           0x80u
+#define SIM_SCGC6_DMAMUX0_MASK         0x2u
+#define SIM_SCGC7_DMA_MASK             0x2u
+#define DMAMUX_CHCFG_SOURCE_MASK       0x3Fu
+#define DMAMUX_CHCFG_SOURCE(x)         (((uint8_t)(x)) & DMAMUX_CHCFG_SOURCE_MASK)
+#define DMAMUX_CHCFG_ENBL_MASK         0x80u
+#define DMA_ATTR_DSIZE(x)              (((uint16_t)(x)) & 0x7u)
+#define DMA_ATTR_SSIZE(x)              ((((uint16_t)(x)) << 8) & 0x700u)
+#define DMA_CSR_INTMAJOR_MASK          0x2u
+#define DMA_CSR_INTHALF_MASK           0x4u
+#define DMA_CSR_DREQ_MASK              0x8u
+#define UART_BDH_SBR_MASK              0x1Fu
+#define UART_C2_RE_MASK                0x4u
+#define UART_C2_TE_MASK                0x8u
+#define UART_C2_ILIE_MASK              0x10u
+#define UART_C2_RIE_MASK               0x20u
+#define UART_C2_TCIE_MASK              0x40u
+#define UART_C2_TIE_MASK               0x80u
+#define UART_S1_PF_MASK                0x1u
+#define UART_S1_FE_MASK                0x2u
+#define UART_S1_NF_MASK                0x4u
+#define UART_S1_OR_MASK                0x8u
+#define UART_S1_IDLE_MASK              0x10u
+#define UART_S1_RDRF_MASK              0x20u
+#define UART_S1_TC_MASK                0x40u
+#define UART_S1_TDRE_MASK              0x80u
+#define UART_C4_BRFA_MASK              0x1Fu
+#define UART_C4_BRFA(x)                (((uint8_t)(x)) & UART_C4_BRFA_MASK)
+#define UART_C5_RDMAS_MASK             0x20u
+#define UART_C5_TDMAS_MASK             0x80u
+#define UART_PFIFO_RXFIFOSIZE_MASK     0x7u
+#define UART_PFIFO_RXFIFOSIZE_SHIFT    0
+#define UART_PFIFO_RXFE_MASK           0x8u
+#define UART_PFIFO_TXFIFOSIZE_MASK     0x70u
+#define UART_PFIFO_TXFIFOSIZE_SHIFT    4
+#define UART_PFIFO_TXFE_MASK           0x80u
+#define UART_CFIFO_RXFLUSH_MASK        0x40u
+#define UART_CFIFO_TXFLUSH_MASK        0x80u
+#define UART_SFIFO_RXUF_MASK           0x1u
+
+#endif
@@ -0,0 +1,36 @@
+/*! @file
+ *
+ *  @brief Host stand-in for the Processor Expert types header.
+ *
+ *  The virtual tower runs in a single thread, so critical sections have nothing to protect against.
+ *  A host program that shares a FIFO between threads builds with HOST_CRITICAL_LOCK and supplies
+ *  HostCritical_Enter and HostCritical_Exit, which take and give back a lock.
+ *
+ *  @author Liang Wang
+ *  @date 2016-07-20
+ */
+
+#ifndef PE_TYPES_H
+#define PE_TYPES_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint8_t uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+typedef int8_t int8;
+typedef int16_t int16;
+typedef int32_t int32;
+
+#ifdef HOST_CRITICAL_LOCK
+void HostCritical_Enter(void);
+void HostCritical_Exit(void);
+#define EnterCritical() HostCritical_Enter()
+#define ExitCritical()  HostCritical_Exit()
+#else
+#define EnterCritical() do { } while (0)
+#define ExitCritical()  do { } while (0)
+#endif
+
+#endif
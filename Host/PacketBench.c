@@ -0,0 +1,249 @@
+/*! @file
+ *
+ *  @brief Packet benchmark: times Packet_Get on clean and corrupted input, and how quickly it gets back in step.
+ *
+ *  packet.c is built unchanged, with the UART replaced by a buffer that UART_InChar reads from, so only the
+ *  framing is timed, and by a TxFIFO that is emptied by hand. Three streams are fed through Packet_Get:
+ *    clean    - valid packets back to back
+ *    garbage  - random bytes only, any packet found in them is a false one
+ *    bursts   - valid packets with a burst of 1 to 64 random bytes before each, as line noise or a PC
+ *               connecting mid-stream would leave; a packet is recovered if it comes out of Packet_Get
+ *               unchanged, and every packet after a burst should be
+ *  Then the checksum is switched to CRC-8 with telemetry, a slot packet and the reply queued, as the checksum
+ *  command does. The bytes already in TxFIFO go out checked the old way, every packet after them has to pass
+ *  CRC-8, and the program exits with 1 if one does not.
+ *
+ *  Build and run from the top of the repository:
+ *    gcc -std=gnu99 -O2 -IHost -ISources -o packetbench Host/PacketBench.c Sources/packet.c Sources/FIFO.c Sources/CRC.c
+ *    ./packetbench
+ *
+ *  @author Liang Wang
+ *  @date 2016-08-10
+ */
+/*!
+**  @addtogroup PacketBench_module PacketBench module documentation
+**  @{
+*/
+/* MODULE PacketBench */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "packet.h"
+#include "protocol.h"
+#include "CRC.h"
+
+#define NB_PACKETS 200000
+#define MAX_BURST 64
+#define STREAM_SIZE (NB_PACKETS * (PACKET_NB_BYTES + MAX_BURST))
+#define NB_RUNS 5
+#define TELEMETRY_CMD 0x10                            /*!<command of the telemetry packets*/
+#define FRAME_CMD 0x13                                /*!<command of the telemetry frames*/
+#define OUTPUT_SIZE 4096                              /*!<more than everything the checksum test queues*/
+
+static uint8_t *Stream;                               /*!<bytes UART_InChar hands out*/
+static size_t StreamSize, StreamIndex;
+static uint8_t (*Sent)[PACKET_NB_BYTES];              /*!<the valid packets in Stream*/
+static TFIFO TxFIFO;                                  /*!<what packet.c sends, as UART.c queues it*/
+FIFO_BUFFER(TxBuffer, UART_TX_FIFO_SIZE);
+static void (*TxCallback)(void);                      /*!<tops up TxFIFO with telemetry*/
+static uint8_t Output[OUTPUT_SIZE];                   /*!<the bytes taken out of TxFIFO, as if sent*/
+
+BOOL UART_Init(const uint32_t baudRate, const uint32_t moduleClk)
+{
+  (void)baudRate;
+  (void)moduleClk;
+  FIFO_Init(&TxFIFO, TxBuffer, sizeof(TxBuffer));
+  return bTRUE;
+}
+
+void UART_SetRxCallback(void (*userFunction)(const uint8_t))
+{
+  (void)userFunction;
+}
+
+void UART_SetTxCallback(void (*userFunction)(void))
+{
+  TxCallback = userFunction;
+}
+
+BOOL UART_InChar(uint8_t* const dataPtr)
+{
+  if (StreamIndex == StreamSize)
+    return bFALSE;
+  *dataPtr = Stream[StreamIndex++];
+  return bTRUE;
+}
+
+BOOL UART_OutReserve(const uint16_t nbBytes, TFIFOSpan* const span)
+{
+  return FIFO_Reserve(&TxFIFO, nbBytes, span);
+}
+
+void UART_OutCommit(const uint16_t nbBytes)
+{
+  FIFO_Commit(&TxFIFO, nbBytes);
+}
+
+uint16_t UART_OutNbBytes(void)
+{
+  return TxFIFO.NbBytes;
+}
+
+/*! @brief Builds a stream of valid packets, each after a burst of random bytes.
+ *
+ *  @param maxBurst The most random bytes before a packet, 0 for none.
+ *  @param nbPackets The number of packets, 0 for random bytes only.
+ *  @return void
+ */
+static void Build(const unsigned maxBurst, const unsigned nbPackets)
+{
+  unsigned i, j;
+
+  StreamSize = 0;
+  if (nbPackets == 0)
+  {
+    for (StreamSize = 0; StreamSize < STREAM_SIZE; StreamSize++)
+      Stream[StreamSize] = rand();
+    return;
+  }
+  for (i = 0; i < nbPackets; i++)
+  {
+    unsigned burst = maxBurst ? 1 + rand() % maxBurst : 0;
+
+    for (j = 0; j < burst; j++)
+      Stream[StreamSize++] = rand();
+    for (j = 0; j < PACKET_NB_BYTES - 1; j++)
+      Sent[i][j] = rand();
+    /*!a command with PACKET_TAG_MASK set starts a tagged packet, keep these plain*/
+    Sent[i][0] &= ~PACKET_TAG_MASK;
+    Sent[i][4] = Sent[i][0] ^ Sent[i][1] ^ Sent[i][2] ^ Sent[i][3];
+    memcpy(&Stream[StreamSize], Sent[i], PACKET_NB_BYTES);
+    StreamSize += PACKET_NB_BYTES;
+  }
+}
+
+/*! @brief Feeds the stream through Packet_Get and prints what came out.
+ *
+ *  @param name The name of the stream.
+ *  @param nbPackets The number of valid packets in the stream.
+ *  @return void
+ */
+static void Run(const char *name, const unsigned nbPackets)
+{
+  struct timespec start, end;
+  double best = 0;
+  unsigned run, nbFound = 0, nbRecovered = 0, next, k;
+
+  for (run = 0; run < NB_RUNS; run++)
+  {
+    double ns;
+
+    StreamIndex = 0;
+    nbFound = 0;
+    nbRecovered = 0;
+    next = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while (StreamIndex < StreamSize)
+      if (Packet_Get())
+      {
+        nbFound++;
+        /*!a false packet that takes the first bytes of a sent one loses it, so look a few packets ahead*/
+        for (k = next; k < nbPackets && k < next + 4; k++)
+          if (memcmp(Packet.Bytes, Sent[k], PACKET_NB_BYTES) == 0)
+          {
+            nbRecovered++;
+            next = k + 1;
+            break;
+          }
+      }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    ns = ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / StreamSize;
+    if (run == 0 || ns < best)
+      best = ns;
+  }
+  printf("%-8s %9zu bytes %6.2f ns/byte  packets: %6u sent %6u recovered %6u lost %6u false\n",
+         name, StreamSize, best, nbPackets, nbRecovered, nbPackets - nbRecovered, nbFound - nbRecovered);
+}
+
+/*! @brief Switches to CRC-8 with telemetry still queued and checks the checksum of every packet sent after.
+ *
+ *  @return int - Non-zero if a packet does not pass the check it was sent with.
+ */
+static int Checksum(void)
+{
+  uint8_t data[20];
+  uint16_t nbOld;                 /*!< bytes in TxFIFO at the switch, checked the old way*/
+  uint16_t nbBytes = 0, size, i, k;
+  unsigned nbXOR = 0, nbCRC = 0, nbBad = 0;
+  uint8_t checksum;
+
+  for (i = 0; i < sizeof(data); i++)
+    data[i] = i * 7;
+  /*!nothing is sent meanwhile, so TxFIFO fills to PACKET_TELEMETRY_TX_LIMIT and the rest waits in the queue*/
+  for (i = 0; i < 40; i++)
+  {
+    Packet_PutTelemetry(TELEMETRY_CMD, i, i + 1, i + 2);
+    if (i % 5 == 0)
+      Packet_PutTelemetryFrame(FRAME_CMD, data, i % sizeof(data));
+  }
+  Packet_PutLatest(1, TELEMETRY_CMD, 9, 9, 9);
+  /*!the reply goes out checked the old way, then the switch*/
+  Packet_Put(TOWER_CHECKSUM_CMD, PACKET_CHECKSUM_CRC8, 0, 0);
+  nbOld = TxFIFO.NbBytes;
+  Packet_SetChecksum(PACKET_CHECKSUM_CRC8);
+  /*!send it all, topped up as the transmit interrupt does*/
+  do
+  {
+    while (nbBytes < OUTPUT_SIZE && FIFO_Get(&TxFIFO, &Output[nbBytes]))
+      nbBytes++;
+    TxCallback();
+  } while (TxFIFO.NbBytes && nbBytes < OUTPUT_SIZE);
+  for (i = 0; i < nbBytes; i += size)
+  {
+    size = (Output[i] == FRAME_CMD) ? Output[i + 1] + PACKET_FRAME_OVERHEAD : PACKET_NB_BYTES;
+    if (i + size > nbBytes)
+    {
+      nbBad++;
+      break;
+    }
+    if (i + size <= nbOld)
+    {
+      for (checksum = 0, k = i; k < i + size - 1; k++)
+        checksum ^= Output[k];
+      nbXOR++;
+    }
+    else
+    {
+      checksum = CRC_8(&Output[i], size - 1);
+      nbCRC++;
+    }
+    if (checksum != Output[i + size - 1])
+      nbBad++;
+  }
+  printf("checksum %9u bytes, packets: %6u before the switch %6u after %6u failing their check\n",
+         nbBytes, nbXOR, nbCRC, nbBad);
+  return nbBad != 0 || nbCRC == 0;
+}
+
+int main(void)
+{
+  Stream = malloc(STREAM_SIZE);
+  Sent = malloc(NB_PACKETS * sizeof(*Sent));
+  if (!Stream || !Sent || !Packet_Init(115200, 60000000))
+    return 1;
+  srand(1);
+
+  Build(0, NB_PACKETS);
+  Run("clean", NB_PACKETS);
+  Build(0, 0);
+  Run("garbage", 0);
+  Build(MAX_BURST, NB_PACKETS);
+  Run("bursts", NB_PACKETS);
+  return Checksum();
+}
+
+/* END PacketBench */
+/*!
+** @}
+*/
@@ -0,0 +1,241 @@
+/*! @file
+ *
+ *  @brief Pipeline benchmark: sends tagged requests with a window of them in flight and reports requests/s.
+ *
+ *  Sends TOWER_NUMBER_CMD requests for the tower number, with the acknowledgement bit and a tag, to the tower
+ *  (or the virtual tower) on a serial device. A request is done when its acknowledgement comes back with its
+ *  tag. The requests are sent first one at a time, waiting for each acknowledgement as a PC client has to
+ *  without tags, then with up to the given number of them in flight, and the request rates are compared.
+ *  Every reply is checked against the request its tag points to.
+ *
+ *  Build and run from the top of the repository:
+ *    gcc -std=gnu99 -O2 -o pipelinebench Host/PipelineBench.c
+ *    ./pipelinebench /dev/ttyUSB0 [baud rate] [requests] [window]
+ *
+ *  @author Liang Wang
+ *  @date 2016-08-13
+ */
+/*!
+**  @addtogroup PipelineBench_module PipelineBench module documentation
+**  @{
+*/
+/* MODULE PipelineBench */
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/select.h>
+
+#define TOWER_NUMBER_CMD 0x0B
+#define GET_TOWER_NUMBER 0x01
+#define ACK_MASK 0x80
+#define TAG_MASK 0x40                                 /*!<PACKET_TAG_MASK*/
+#define PACKET_NB_BYTES 5
+#define TAGGED_NB_BYTES 6
+#define MAX_WINDOW 128                                /*!<half the tags, so a late reply cannot be taken for a new request*/
+#define TIMEOUT_US 1000000
+
+static uint32_t Sent[256];                            /*!<time each tag was sent, in microseconds*/
+static uint8_t InFlight[256];                         /*!<1 while the request with that tag waits for its acknowledgement*/
+static unsigned NbInFlight, NbDone, NbReplies, NbBad, NbChecksumErrors;
+static uint64_t TotalLatency;
+
+/*! @brief Gets the PC's time in microseconds.
+ *
+ *  @return uint32_t - The time, wraps around after about 71 minutes.
+ */
+static uint32_t Microseconds(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)((uint64_t)now.tv_sec * 1000000u + now.tv_nsec / 1000);
+}
+
+/*! @brief Opens a serial device raw at a baud rate.
+ *
+ *  @return int - The file descriptor, -1 on error.
+ */
+static int Open(const char *name, const unsigned baudRate)
+{
+  static const struct { unsigned rate; speed_t speed; } speeds[] =
+    {{9600, B9600}, {38400, B38400}, {57600, B57600}, {115200, B115200}, {230400, B230400}, {460800, B460800}, {921600, B921600}};
+  struct termios settings;
+  int fd = open(name, O_RDWR | O_NOCTTY);
+  unsigned i;
+
+  if (fd < 0 || tcgetattr(fd, &settings))
+  {
+    perror(name);
+    return -1;
+  }
+  cfmakeraw(&settings);
+  for (i = 0; i < sizeof(speeds) / sizeof(speeds[0]); i++)
+    if (speeds[i].rate == baudRate)
+      cfsetspeed(&settings, speeds[i].speed);
+  if (tcsetattr(fd, TCSANOW, &settings))
+  {
+    perror(name);
+    return -1;
+  }
+  tcflush(fd, TCIOFLUSH);
+  return fd;
+}
+
+/*! @brief Sends a tagged request for the tower number, with the acknowledgement bit.
+ *
+ *  @return void
+ */
+static void Put(const int fd, const uint8_t tag)
+{
+  uint8_t packet[TAGGED_NB_BYTES] = {TOWER_NUMBER_CMD | ACK_MASK | TAG_MASK, tag, GET_TOWER_NUMBER, 0, 0};
+
+  packet[5] = packet[0] ^ packet[1] ^ packet[2] ^ packet[3] ^ packet[4];
+  if (write(fd, packet, sizeof(packet)) != sizeof(packet))
+    perror("write");
+  Sent[tag] = Microseconds();
+  InFlight[tag] = 1;
+  NbInFlight++;
+}
+
+/*! @brief Handles a tagged reply.
+ *
+ *  @param p The reply.
+ *  @param now The time it was received.
+ *  @return void
+ */
+static void Reply(const uint8_t *p, const uint32_t now)
+{
+  uint8_t command = p[0] & ~TAG_MASK;
+  uint8_t tag = p[1];
+
+  NbReplies++;
+  if (!InFlight[tag] || (command & ~ACK_MASK) != TOWER_NUMBER_CMD || p[2] != GET_TOWER_NUMBER)
+  {
+    NbBad++;
+    return;
+  }
+  /*!the number comes first, then the acknowledgement that ends the request*/
+  if (command & ACK_MASK)
+  {
+    InFlight[tag] = 0;
+    NbInFlight--;
+    NbDone++;
+    TotalLatency += now - Sent[tag];
+  }
+}
+
+/*! @brief Frames the received bytes into packets, tagged ones are handled.
+ *
+ *  @param buffer The bytes not framed yet.
+ *  @param nbBytes The number of them.
+ *  @param now The time they were received.
+ *  @return size_t - The number of bytes used up.
+ */
+static size_t Frame(const uint8_t *buffer, const size_t nbBytes, const uint32_t now)
+{
+  size_t used = 0;
+
+  while (nbBytes - used >= PACKET_NB_BYTES)
+  {
+    const uint8_t *p = &buffer[used];
+    size_t size = (p[0] & TAG_MASK) ? TAGGED_NB_BYTES : PACKET_NB_BYTES;
+    uint8_t checksum = 0;
+    size_t i;
+
+    if (nbBytes - used < size)
+      break;
+    for (i = 0; i < size - 1; i++)
+      checksum ^= p[i];
+    if (checksum != p[size - 1])
+    {
+      NbChecksumErrors++;
+      used++;
+      continue;
+    }
+    if (size == TAGGED_NB_BYTES)
+      Reply(p, now);
+    used += size;
+  }
+  return used;
+}
+
+/*! @brief Sends requests with up to a window of them in flight.
+ *
+ *  @param fd The serial device.
+ *  @param nbRequests The number of requests.
+ *  @param window The most requests in flight.
+ *  @return int - 0 if every request was acknowledged.
+ */
+static int Run(const int fd, const unsigned nbRequests, const unsigned window)
+{
+  uint8_t buffer[4096];
+  size_t nbBytes = 0;
+  unsigned nbSent = 0;
+  uint32_t start, last;
+
+  memset(InFlight, 0, sizeof(InFlight));
+  NbInFlight = NbDone = NbReplies = NbBad = NbChecksumErrors = 0;
+  TotalLatency = 0;
+  tcflush(fd, TCIOFLUSH);
+  start = last = Microseconds();
+  while (NbDone < nbRequests && Microseconds() - last < TIMEOUT_US)
+  {
+    struct timeval timeout = {0, 10000};
+    fd_set fds;
+    ssize_t n;
+    size_t used;
+    unsigned done = NbDone;
+
+    while (nbSent < nbRequests && NbInFlight < window)
+      Put(fd, nbSent++ & 0xFF);
+    FD_ZERO(&fds);
+    FD_SET(fd, &fds);
+    if (select(fd + 1, &fds, NULL, NULL, &timeout) <= 0)
+      continue;
+    n = read(fd, &buffer[nbBytes], sizeof(buffer) - nbBytes);
+    if (n <= 0)
+      break;
+    nbBytes += n;
+    used = Frame(buffer, nbBytes, Microseconds());
+    memmove(buffer, &buffer[used], nbBytes - used);
+    nbBytes -= used;
+    if (NbDone != done)
+      last = Microseconds();
+  }
+  printf("window %3u: %u of %u requests in %.3f s, %7.1f requests/s, mean latency %6.2f ms, %u replies, %u bad, %u checksum errors\n",
+         window, NbDone, nbRequests, (last - start) / 1e6, NbDone * 1e6 / (last - start),
+         NbDone ? TotalLatency / 1e3 / NbDone : 0.0, NbReplies, NbBad, NbChecksumErrors);
+  return NbDone != nbRequests || NbBad;
+}
+
+int main(int argc, char *argv[])
+{
+  unsigned baudRate = (argc > 2) ? atoi(argv[2]) : 115200;
+  unsigned nbRequests = (argc > 3) ? atoi(argv[3]) : 1000;
+  unsigned window = (argc > 4) ? atoi(argv[4]) : 8;
+  int fd, failed;
+
+  if (argc < 2 || window == 0 || window > MAX_WINDOW)
+  {
+    fprintf(stderr, "usage: %s device [baud rate] [requests] [window, 1 to %u]\n", argv[0], MAX_WINDOW);
+    return 1;
+  }
+  fd = Open(argv[1], baudRate);
+  if (fd < 0)
+    return 1;
+  failed = Run(fd, nbRequests, 1);
+  if (window > 1)
+    failed |= Run(fd, nbRequests, window);
+  close(fd);
+  return failed;
+}
+
+/* END PipelineBench */
+/*!
+** @}
+*/
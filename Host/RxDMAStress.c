@@ -0,0 +1,336 @@
+/*! @file
+ *
+ *  @brief Receive eDMA stress test: UART.c built with UART_RX_DMA is fed bursts through a model of UART2 and
+ *  its eDMA channel, and every byte is checked.
+ *
+ *  The model runs a byte time at a time. A byte that arrives while C5 RDMAS selects DMA requests is copied
+ *  by the channel as its TCD says: to DADDR, counting CITER down, with the channel interrupt raised halfway
+ *  through the major loop and at its end. Otherwise it sets RDRF and raises the UART interrupt. Between bursts
+ *  the line goes idle, which sets IDLE; reading S1 and then the channel's read of D clears it. The channel
+ *  interrupt is taken up to nearly half a loop late and the idle line one up to IDLE_MAX_DELAY byte times
+ *  late, so a burst can start before it is taken. The bytes follow a pseudo-random sequence, so a byte lost,
+ *  repeated or reordered shows up as a mismatch. Two consumers are run:
+ *    polled   - UART_InChar at random times, with pauses long enough for the channel to write over bytes
+ *               not yet taken, which must be dropped and counted in RxDropped rather than handed out
+ *    callback - UART_SetRxCallback, which must be given every byte, the last ones of a burst once the
+ *               idle line interrupt has been taken
+ *  UART_InNbBytes is also checked against what the model has written and the consumer has taken.
+ *
+ *  The program exits with 1 if a byte does not arrive in order or is not accounted for.
+ *
+ *  Build and run from the top of the repository:
+ *    gcc -std=gnu99 -O2 -no-pie -DUART_RX_DMA=1 -IHost -ISources -o rxdmastress Host/RxDMAStress.c Sources/UART.c Sources/FIFO.c
+ *    ./rxdmastress [megabytes]
+ *  UART.c puts the 32-bit address of its buffer in DADDR, -no-pie keeps it below 4 GB.
+ *
+ *  @author Liang Wang
+ *  @date 2016-08-18
+ */
+/*!
+**  @addtogroup RxDMAStress_module RxDMAStress module documentation
+**  @{
+*/
+/* MODULE RxDMAStress */
+#include <stdio.h>
+#include <stdlib.h>
+#include "Cpu.h"
+#include "UART.h"
+
+#define RX_DMA_SOURCE 6                               /*!<DMAMUX request source of the UART2 receiver*/
+#define NB_CHANNELS 16
+#define BURST_MAX 3000                                /*!<bytes in a burst at most*/
+#define IDLE_MAX 40                                   /*!<byte times the line stays idle between bursts at most*/
+#define IDLE_MAX_DELAY 20                             /*!<byte times the idle line interrupt is taken late at most*/
+#define PAUSE_MAX (2 * UART_RX_DMA_SIZE)              /*!<byte times the polled consumer leaves the bytes at most*/
+
+volatile uint32_t SIM_SCGC4, SIM_SCGC5, SIM_SCGC6, SIM_SCGC7;
+volatile uint32_t PORTE_PCR16, PORTE_PCR17;
+volatile uint32_t NVICICPR0, NVICISER0, NVICICPR1, NVICISER1;
+volatile uint8_t UART2_BDH, UART2_BDL, UART2_C1, UART2_C2, UART2_C4, UART2_C5, UART2_MODEM;
+volatile uint8_t UART2_PFIFO, UART2_CFIFO, UART2_SFIFO, UART2_TWFIFO, UART2_RWFIFO, UART2_TCFIFO, UART2_RCFIFO;
+volatile uint8_t HostDMA_CHCFG[NB_CHANNELS];
+volatile THostDMATCD HostDMA_TCD[NB_CHANNELS];
+volatile uint8_t DMA_SERQ, DMA_CINT;
+
+static uint8_t S1;                                    /*!<the UART status*/
+static volatile uint16_t D;                           /*!<the UART data register*/
+static BOOL IdleRead;                                 /*!<S1 was read with IDLE set, the next read of D clears it*/
+static BOOL IdleArmed;                                /*!<a byte has arrived since IDLE was set, so an idle line sets it again*/
+static int Channel;                                   /*!<the eDMA channel UART.c set up*/
+static BOOL ChannelInterrupt;                         /*!<the channel's interrupt request*/
+static unsigned ChannelDelay, IdleDelay;              /*!<byte times until the interrupts are taken*/
+static unsigned long NbBytes;                         /*!<bytes each run sends*/
+static unsigned long Written;                         /*!<bytes the channel has written*/
+static unsigned long Taken, Dropped;                  /*!<bytes the consumer got, and the ones UART.c dropped*/
+static unsigned long IdleTakenAt;                     /*!<Written when the idle line interrupt was last taken*/
+static unsigned long NbChannelInterrupts, NbIdleInterrupts;
+static uint16_t LastDropped;                          /*!<RxDropped when it was last read*/
+static unsigned long NbErrors;
+
+/*! @brief Counts and prints a failed check.
+ *
+ */
+static void Fail(const char *what)
+{
+  if (NbErrors++ < 10)
+    printf("  FAILED after %lu bytes: %s\n", Written, what);
+}
+
+uint8_t HostUART_S1(void)
+{
+  if (S1 & UART_S1_IDLE_MASK)
+    IdleRead = bTRUE;
+  return S1;
+}
+
+volatile uint16_t* HostUART_D(void)
+{
+  /*!in this mode the CPU never reads D, only the channel does*/
+  return &D;
+}
+
+/*! @brief Gets a byte of the sequence the line carries.
+ *
+ *  @return uint8_t - The byte.
+ */
+static uint8_t Byte(const unsigned long index)
+{
+  return (uint8_t)((index * 2654435761u) >> 13);
+}
+
+/*! @brief Brings Dropped up to date with RxDropped.
+ *
+ */
+static void ReadDropped(void)
+{
+  TUARTStats stats;
+
+  UART_GetStats(&stats);
+  Dropped += (uint16_t)(stats.RxDropped - LastDropped);
+  LastDropped = stats.RxDropped;
+}
+
+/*! @brief Checks a byte handed to the consumer, after the ones UART.c says it dropped.
+ *
+ */
+static void Check(const uint8_t data)
+{
+  ReadDropped();
+  if (data != Byte(Taken + Dropped))
+    Fail("a byte is out of order");
+  Taken++;
+}
+
+/*! @brief Checks the bytes UART.c says are waiting against what the channel has written and the consumer taken.
+ *
+ */
+static void CheckWaiting(void)
+{
+  unsigned long waiting;
+
+  ReadDropped();
+  waiting = Written - Taken - Dropped;
+  if (UART_InNbBytes() != ((waiting > UART_RX_DMA_SIZE) ? UART_RX_DMA_SIZE : waiting))
+    Fail("UART_InNbBytes does not match the bytes written and taken");
+}
+
+/*! @brief Raises the channel interrupt, to be taken before the channel gets halfway round its loop again.
+ *
+ */
+static void RaiseChannelInterrupt(void)
+{
+  if (ChannelInterrupt)
+    Fail("the channel interrupt was raised again before it was taken");
+  ChannelInterrupt = bTRUE;
+  ChannelDelay = rand() % (UART_RX_DMA_SIZE / 2 - 1);
+}
+
+/*! @brief The channel reads D and writes the byte where its TCD says.
+ *
+ */
+static void ChannelRequest(void)
+{
+  volatile THostDMATCD *tcd = &HostDMA_TCD[Channel];
+
+  *(uint8_t*)(uintptr_t)tcd->DADDR = (uint8_t)D;
+  S1 &= ~UART_S1_RDRF_MASK;
+  if (IdleRead)
+    S1 &= ~UART_S1_IDLE_MASK;
+  IdleRead = bFALSE;
+  tcd->DADDR += tcd->DOFF;
+  Written++;
+  if (--tcd->CITER_ELINKNO == 0)
+  {
+    tcd->DADDR += tcd->DLAST_SGA;
+    tcd->CITER_ELINKNO = tcd->BITER_ELINKNO;
+    if (tcd->CSR & DMA_CSR_INTMAJOR_MASK)
+      RaiseChannelInterrupt();
+  }
+  else if (tcd->CITER_ELINKNO == tcd->BITER_ELINKNO / 2 && (tcd->CSR & DMA_CSR_INTHALF_MASK))
+    RaiseChannelInterrupt();
+}
+
+/*! @brief Passes a received byte on: the UART interrupt, taken straight away, or a request to the channel.
+ *
+ */
+static void Serve(void)
+{
+  if (!(S1 & UART_S1_RDRF_MASK) || !(UART2_C2 & UART_C2_RIE_MASK))
+    return;
+  if (!(UART2_C5 & UART_C5_RDMAS_MASK))
+    UART_ISR();
+  if ((S1 & UART_S1_RDRF_MASK) && (UART2_C5 & UART_C5_RDMAS_MASK)
+      && (HostDMA_CHCFG[Channel] & DMAMUX_CHCFG_ENBL_MASK) && DMA_SERQ == Channel)
+    ChannelRequest();
+}
+
+/*! @brief A byte time passes, the interrupts that are due are taken.
+ *
+ */
+static void Tick(void)
+{
+  if (ChannelInterrupt && ChannelDelay-- == 0)
+  {
+    ChannelInterrupt = bFALSE;
+    NbChannelInterrupts++;
+    DMA_CINT = NB_CHANNELS;
+    UART_RxDMA_ISR();
+    if (DMA_CINT != Channel)
+      Fail("the channel interrupt was not cleared");
+  }
+  if ((S1 & UART_S1_IDLE_MASK) && (UART2_C2 & UART_C2_ILIE_MASK))
+  {
+    if (IdleDelay)
+      IdleDelay--;
+    else
+    {
+      NbIdleInterrupts++;
+      IdleTakenAt = Written;
+      UART_ISR();
+      Serve();
+    }
+  }
+}
+
+/*! @brief A byte arrives on the line.
+ *
+ */
+static void Arrive(const uint8_t data)
+{
+  if (S1 & UART_S1_RDRF_MASK)
+    Fail("the UART overran");
+  D = data;
+  S1 |= UART_S1_RDRF_MASK;
+  IdleArmed = bTRUE;
+  Serve();
+  Tick();
+}
+
+/*! @brief The line stays idle for a byte time.
+ *
+ */
+static void Idle(void)
+{
+  if (IdleArmed)
+  {
+    S1 |= UART_S1_IDLE_MASK;
+    IdleArmed = bFALSE;
+    IdleDelay = rand() % IDLE_MAX_DELAY;
+  }
+  Tick();
+}
+
+/*! @brief Takes bytes the way the packet layer does.
+ *
+ */
+static void Consume(const unsigned nbBytes)
+{
+  uint8_t data;
+  unsigned i;
+
+  CheckWaiting();
+  for (i = 0; i < nbBytes && UART_InChar(&data); i++)
+    Check(data);
+}
+
+/*! @brief Runs bursts through the model with one of the consumers and prints the result.
+ *
+ *  @return int - Non-zero if a byte did not arrive in order or is not accounted for.
+ */
+static int Run(const char *name, const BOOL callback)
+{
+  unsigned long burst, gap, pause = 0;
+  TUARTStats stats;
+  int i;
+
+  S1 = UART_S1_TDRE_MASK | UART_S1_TC_MASK;
+  IdleRead = IdleArmed = ChannelInterrupt = bFALSE;
+  Written = Taken = Dropped = LastDropped = 0;
+  IdleTakenAt = NbChannelInterrupts = NbIdleInterrupts = NbErrors = 0;
+  srand(7);
+  UART_Init(115200, CPU_BUS_CLK_HZ);
+  if (callback)
+    UART_SetRxCallback(Check);
+  for (Channel = 0; Channel < NB_CHANNELS; Channel++)
+    if (HostDMA_CHCFG[Channel] == (DMAMUX_CHCFG_ENBL_MASK | DMAMUX_CHCFG_SOURCE(RX_DMA_SOURCE)))
+      break;
+  if (Channel == NB_CHANNELS)
+  {
+    printf("no eDMA channel was set up for the UART2 receiver\n");
+    return 1;
+  }
+  while (Written < NbBytes)
+  {
+    for (burst = 1 + rand() % BURST_MAX; burst > 0; burst--)
+    {
+      Arrive(Byte(Written));
+      if (!callback && pause-- == 0)
+      {
+        Consume(rand() % 64);
+        /*!now and then long enough for the channel to come round and write over bytes not taken*/
+        pause = (rand() % 200) ? rand() % 8 : rand() % PAUSE_MAX;
+      }
+    }
+    for (gap = 1 + rand() % IDLE_MAX; gap > 0; gap--)
+      Idle();
+    if (callback && IdleTakenAt == Written && Taken != Written)
+      Fail("the end of a burst was not delivered when the line went idle");
+  }
+  /*!let the interrupts still due be taken and the consumer catch up*/
+  for (i = 0; i < UART_RX_DMA_SIZE; i++)
+    Idle();
+  if (!callback)
+    Consume(UART_RX_DMA_SIZE);
+  CheckWaiting();
+  ReadDropped();
+  UART_GetStats(&stats);
+  if (Taken + Dropped != Written)
+    Fail("bytes are not accounted for");
+  if (stats.Overruns)
+    Fail("the UART counted overruns");
+  if (callback ? Dropped != 0 : Dropped == 0)
+    Fail(callback ? "the callback lost bytes" : "the pauses did not make the channel write over bytes");
+  printf("%-8s %lu bytes: %lu taken %lu dropped, %lu channel and %lu idle line interrupts, %s\n", name, Written,
+         Taken, Dropped, NbChannelInterrupts, NbIdleInterrupts, NbErrors ? "FAILED" : "all in order");
+  return NbErrors != 0;
+}
+
+int main(int argc, char *argv[])
+{
+  int failed;
+
+  if ((uintptr_t)HostDMA_TCD > UINT32_MAX)
+  {
+    printf("build with -no-pie, the 32-bit addresses in the TCD cannot reach the buffer\n");
+    return 1;
+  }
+  NbBytes = ((argc > 1) ? strtoul(argv[1], NULL, 0) : 16) * 1000000ul;
+  failed = Run("polled", bFALSE);
+  failed |= Run("callback", bTRUE);
+  return failed;
+}
+
+/* END RxDMAStress */
+/*!
+** @}
+*/
@@ -0,0 +1,242 @@
+/*! @file
+ *
+ *  @brief Stream codec: encodes an accelerometer trace into delta frames, decodes them again and compares link usage.
+ *
+ *  delta.c is built unchanged, so the frames are the ones the tower sends with TOWER_ACCELDELTA_CMD and the
+ *  decoder is the one a PC client uses. Every frame is decoded and checked against the trace, then the bytes
+ *  per sample and the most samples per second a 115200 baud link carries are printed for one 5-byte packet
+ *  per sample, raw frames (TOWER_ACCELBATCH_CMD) and delta frames.
+ *
+ *  A trace is a text file with one sample per line, "x y z" or "t x y z" where t is the FTM0 count
+ *  (24414 Hz) and x, y and z are the 8-bit readings. Without a file a synthetic trace is generated:
+ *  the board at rest with one or two counts of noise, picked up and moved now and then.
+ *
+ *  Build and run from the top of the repository:
+ *    gcc -std=gnu99 -O2 -IHost -ISources -o streamcodec Host/StreamCodec.c Sources/delta.c -lm
+ *    ./streamcodec [trace.txt] [samples per second] [samples per frame]
+ *
+ *  @author Liang Wang
+ *  @date 2016-08-05
+ */
+/*!
+**  @addtogroup StreamCodec_module StreamCodec module documentation
+**  @{
+*/
+/* MODULE StreamCodec */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "delta.h"
+
+#define TICKS_PER_SECOND 24414                        /*!<FTM0 counts per second, as in stream.h*/
+#define DT_SHIFT 4                                    /*!<time step resolution, as in stream.h*/
+#define FRAME_OVERHEAD 3                              /*!<command, length and checksum, as in packet.h*/
+#define FRAME_MAX_DATA 255
+#define RAW_HEADER_NB_BYTES 2
+#define RAW_SAMPLE_NB_BYTES 4
+#define RAW_MAX_SAMPLES 32
+#define MAX_SAMPLES_PER_FRAME 255                     /*!<STREAM_MAX_DELTA_SAMPLES*/
+#define PACKET_NB_BYTES 5
+#define LINK_BYTES_PER_SECOND 11520                   /*!<115200 baud, 10 bits per byte*/
+#define SYNTHETIC_NB_SAMPLES 20000
+#define MAX_NB_SAMPLES 1000000
+
+static TDeltaSample *Trace;                           /*!<samples read or generated, times are FTM0 counts*/
+static unsigned NbSamples;
+
+/*! @brief Reads a trace file.
+ *
+ *  @param name The file name.
+ *  @param rate The sample rate used when the lines have no time.
+ *  @return int - 0 if it was read.
+ */
+static int ReadTrace(const char *name, const unsigned rate)
+{
+  FILE *file = fopen(name, "r");
+  char line[128];
+  int v[4];
+  double time = 0;
+
+  if (!file)
+  {
+    perror(name);
+    return -1;
+  }
+  while (NbSamples < MAX_NB_SAMPLES && fgets(line, sizeof(line), file))
+  {
+    TDeltaSample *s = &Trace[NbSamples];
+    int n = sscanf(line, "%d %d %d %d", &v[0], &v[1], &v[2], &v[3]);
+
+    if (n == 3)
+    {
+      s->Time = (uint16_t)time;
+      time += (double)TICKS_PER_SECOND / rate;
+      s->XYZ[0] = v[0]; s->XYZ[1] = v[1]; s->XYZ[2] = v[2];
+    }
+    else if (n == 4)
+    {
+      s->Time = v[0];
+      s->XYZ[0] = v[1]; s->XYZ[1] = v[2]; s->XYZ[2] = v[3];
+    }
+    else
+      continue;
+    NbSamples++;
+  }
+  fclose(file);
+  return 0;
+}
+
+/*! @brief Generates a trace: mostly at rest, with a movement every few seconds.
+ *
+ *  @param rate The sample rate.
+ *  @return void
+ */
+static void MakeTrace(const unsigned rate)
+{
+  double time = 0;
+  int rest[3] = {0, 0, 64};                           /*!<1 g on z at 2 g full scale, 8 bits*/
+  unsigned i, k, moving = 0;
+
+  srand(1);
+  for (i = 0; i < SYNTHETIC_NB_SAMPLES; i++)
+  {
+    TDeltaSample *s = &Trace[NbSamples++];
+
+    if (!moving && rand() % (3 * rate) == 0)
+      moving = rate / 2 + rand() % rate;
+    for (k = 0; k < 3; k++)
+    {
+      int v = rest[k] + rand() % 3 - 1;
+      if (moving)
+        v += (int)(40 * sin(6.28 * i * (k + 1) / rate));
+      s->XYZ[k] = (uint8_t)v;
+    }
+    if (moving)
+      moving--;
+    /*!the accelerometer clock is not the FTM0 clock, so the time steps jitter by a count*/
+    s->Time = (uint16_t)(time + rand() % 2);
+    time += (double)TICKS_PER_SECOND / rate;
+  }
+}
+
+/*! @brief Prints the cost of one way of sending the trace.
+ *
+ *  @return void
+ */
+static void Report(const char *name, const unsigned long nbBytes, const unsigned nbFrames)
+{
+  double perSample = (double)nbBytes / NbSamples;
+
+  printf("%-16s %8lu bytes %6u frames %6.2f bytes/sample %6.0f samples/s at 115200\n",
+         name, nbBytes, nbFrames, perSample, LINK_BYTES_PER_SECOND / perSample);
+}
+
+/*! @brief Decodes a frame and checks it against the trace.
+ *
+ *  @param data The frame data.
+ *  @param nbBytes The number of bytes of data.
+ *  @param first The index of the first sample of the frame in the trace.
+ *  @param nbEncoded The number of samples the encoder took.
+ *  @param times The times the tower sends, rounded to the time step.
+ *  @return int - 0 if the frame decodes to the trace.
+ */
+static int Check(const uint8_t *data, const uint16_t nbBytes, const unsigned first, const unsigned nbEncoded, const uint16_t *times)
+{
+  TDeltaSample decoded[FRAME_MAX_DATA];
+  uint16_t n = Delta_Decode(data, nbBytes, decoded, FRAME_MAX_DATA, DT_SHIFT);
+  unsigned i, k;
+
+  if (n != nbEncoded)
+  {
+    printf("frame at sample %u: %u samples decoded, %u encoded\n", first, n, nbEncoded);
+    return -1;
+  }
+  for (i = 0; i < n; i++)
+  {
+    for (k = 0; k < 3; k++)
+      if (decoded[i].XYZ[k] != Trace[first + i].XYZ[k])
+      {
+        printf("sample %u: axis %u is %u, should be %u\n", first + i, k, decoded[i].XYZ[k], Trace[first + i].XYZ[k]);
+        return -1;
+      }
+    if (decoded[i].Time != times[i])
+    {
+      printf("sample %u: time is %u, should be %u\n", first + i, decoded[i].Time, times[i]);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+int main(int argc, char *argv[])
+{
+  unsigned rate = (argc > 2) ? atoi(argv[2]) : 100;
+  unsigned perFrame = (argc > 3) ? atoi(argv[3]) : MAX_SAMPLES_PER_FRAME;
+  unsigned i, nbFrames;
+  unsigned long nbBytes;
+
+  if (rate == 0 || perFrame == 0 || perFrame > MAX_SAMPLES_PER_FRAME)
+  {
+    fprintf(stderr, "usage: %s [trace.txt] [samples per second] [samples per frame, 1 to %u]\n", argv[0], MAX_SAMPLES_PER_FRAME);
+    return 1;
+  }
+  Trace = malloc(MAX_NB_SAMPLES * sizeof(*Trace));
+  if (!Trace)
+    return 1;
+  if (argc > 1 && argv[1][0] != '-')
+  {
+    if (ReadTrace(argv[1], rate))
+      return 1;
+  }
+  else
+    MakeTrace(rate);
+  if (NbSamples == 0)
+  {
+    fprintf(stderr, "no samples\n");
+    return 1;
+  }
+  printf("%u samples at %u samples/s, up to %u samples per frame\n", NbSamples, rate, perFrame);
+
+  Report("packets", (unsigned long)NbSamples * PACKET_NB_BYTES, NbSamples);
+
+  nbFrames = (NbSamples + RAW_MAX_SAMPLES - 1) / RAW_MAX_SAMPLES;
+  Report("raw frames", (unsigned long)NbSamples * RAW_SAMPLE_NB_BYTES + nbFrames * (FRAME_OVERHEAD + RAW_HEADER_NB_BYTES), nbFrames);
+
+  /*!frame the trace as stream.c does: a new frame when it is full, the time step does not fit or the sample does not fit*/
+  nbBytes = 0;
+  nbFrames = 0;
+  i = 0;
+  while (i < NbSamples)
+  {
+    uint8_t frame[FRAME_MAX_DATA];
+    uint16_t times[FRAME_MAX_DATA];
+    TDeltaEncoder encoder;
+    uint16_t last = Trace[i].Time;
+    unsigned n = 1;
+
+    Delta_Start(&encoder, frame, sizeof(frame), Trace[i].Time, Trace[i].XYZ);
+    times[0] = last;
+    while (i + n < NbSamples && n < perFrame)
+    {
+      uint16_t dt = (uint16_t)(Trace[i + n].Time - last) >> DT_SHIFT;
+
+      if (dt > 0xFF || !Delta_Add(&encoder, (uint8_t)dt, Trace[i + n].XYZ))
+        break;
+      last += dt << DT_SHIFT;
+      times[n++] = last;
+    }
+    if (Check(frame, Delta_NbBytes(&encoder), i, n, times))
+      return 1;
+    nbBytes += FRAME_OVERHEAD + Delta_NbBytes(&encoder);
+    nbFrames++;
+    i += n;
+  }
+  Report("delta frames", nbBytes, nbFrames);
+  printf("all %u delta frames decoded to the trace\n", nbFrames);
+  return 0;
+}
+
+/* END StreamCodec */
+/*!
+** @}
+*/
@@ -0,0 +1,278 @@
+/*! @file
+ *
+ *  @brief Telemetry stats: turns on extended telemetry and reports loss, reordering and latency of the stream.
+ *
+ *  Sends TOWER_EXTENDED_CMD to the tower (or the virtual tower) on a serial device, then reads the stream
+ *  for a while. Each extended frame carries a rolling sequence number and the tower's time in microseconds:
+ *  a jump forward in the sequence is counted as lost packets, a step back as a reordered or repeated one.
+ *  The tower's clock and the PC's are not synchronised, so latency is shown relative to the quickest frame,
+ *  which takes out the offset between the clocks but also the shortest transfer time; drift between the
+ *  clocks is ignored, which is fine for runs of minutes.
+ *
+ *  Build and run from the top of the repository:
+ *    gcc -std=gnu99 -O2 -o telemetrystats Host/TelemetryStats.c
+ *    ./telemetrystats /dev/ttyUSB0 [baud rate] [seconds]
+ *
+ *  @author Liang Wang
+ *  @date 2016-08-09
+ */
+/*!
+**  @addtogroup TelemetryStats_module TelemetryStats module documentation
+**  @{
+*/
+/* MODULE TelemetryStats */
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/select.h>
+
+#define TOWER_ACCELBATCH_CMD 0x13
+#define TOWER_ACCELDELTA_CMD 0x14
+#define TOWER_EXTENDED_CMD 0x15
+#define PACKET_NB_BYTES 5
+#define EXTENDED_NB_DATA 10
+#define MAX_NB_FRAMES 1000000
+#define NB_BUCKETS 10
+
+static const uint32_t BucketLimits[NB_BUCKETS] =     /*!<upper ends of the latency histogram in microseconds*/
+  {500, 1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000, UINT32_MAX};
+
+static int32_t *Delays;                               /*!<PC time minus tower time of each frame, from the first one*/
+static unsigned NbFrames, NbLost, NbReordered, NbPackets, NbChecksumErrors;
+static unsigned NbByCommand[256];                     /*!<extended frames by the command they carry*/
+static uint16_t NextSequence;
+static int32_t FirstDelay;
+
+/*! @brief Gets the PC's time in microseconds.
+ *
+ *  @return uint32_t - The time, wrapping like the tower's.
+ */
+static uint32_t Microseconds(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)((uint64_t)now.tv_sec * 1000000u + now.tv_nsec / 1000);
+}
+
+/*! @brief Opens a serial device raw at a baud rate.
+ *
+ *  @return int - The file descriptor, -1 on error.
+ */
+static int Open(const char *name, const unsigned baudRate)
+{
+  static const struct { unsigned rate; speed_t speed; } speeds[] =
+    {{9600, B9600}, {38400, B38400}, {57600, B57600}, {115200, B115200}, {230400, B230400}, {460800, B460800}, {921600, B921600}};
+  struct termios settings;
+  int fd = open(name, O_RDWR | O_NOCTTY);
+  unsigned i;
+
+  if (fd < 0 || tcgetattr(fd, &settings))
+  {
+    perror(name);
+    return -1;
+  }
+  cfmakeraw(&settings);
+  for (i = 0; i < sizeof(speeds) / sizeof(speeds[0]); i++)
+    if (speeds[i].rate == baudRate)
+      cfsetspeed(&settings, speeds[i].speed);
+  if (tcsetattr(fd, TCSANOW, &settings))
+  {
+    perror(name);
+    return -1;
+  }
+  tcflush(fd, TCIOFLUSH);
+  return fd;
+}
+
+/*! @brief Sends a packet.
+ *
+ *  @return void
+ */
+static void Put(const int fd, const uint8_t command, const uint8_t parameter1, const uint8_t parameter2, const uint8_t parameter3)
+{
+  uint8_t packet[PACKET_NB_BYTES] = {command, parameter1, parameter2, parameter3, command ^ parameter1 ^ parameter2 ^ parameter3};
+
+  if (write(fd, packet, sizeof(packet)) != sizeof(packet))
+    perror("write");
+}
+
+/*! @brief Counts an extended frame.
+ *
+ *  @param data The frame data, EXTENDED_NB_DATA bytes.
+ *  @param now The time the frame was received.
+ *  @return void
+ */
+static void Extended(const uint8_t *data, const uint32_t now)
+{
+  uint16_t sequence = data[0] | (data[1] << 8);
+  uint32_t time = data[2] | (data[3] << 8) | ((uint32_t)data[4] << 16) | ((uint32_t)data[5] << 24);
+  int32_t delay = (int32_t)(now - time);
+  int16_t step = (int16_t)(sequence - NextSequence);
+
+  if (NbFrames == 0)
+    FirstDelay = delay;
+  else if (step > 0)
+    NbLost += step;
+  else if (step < 0)
+    NbReordered++;
+  if (NbFrames == 0 || step >= 0)
+    NextSequence = sequence + 1;
+  NbByCommand[data[6]]++;
+  if (NbFrames < MAX_NB_FRAMES)
+    Delays[NbFrames] = delay - FirstDelay;
+  NbFrames++;
+}
+
+/*! @brief Frames the received bytes into packets and frames.
+ *
+ *  Frames are the commands that are followed by a length, everything else is a 5-byte packet.
+ *  A bad checksum drops the first byte so that the next one can be tried.
+ *  @param buffer The bytes not framed yet.
+ *  @param nbBytes The number of them.
+ *  @param now The time they were received.
+ *  @return size_t - The number of bytes used up.
+ */
+static size_t Frame(const uint8_t *buffer, const size_t nbBytes, const uint32_t now)
+{
+  size_t used = 0;
+
+  while (nbBytes - used >= PACKET_NB_BYTES)
+  {
+    const uint8_t *p = &buffer[used];
+    uint8_t command = p[0];
+    size_t size = PACKET_NB_BYTES;
+    uint8_t checksum = 0;
+    size_t i;
+
+    if (command == TOWER_ACCELBATCH_CMD || command == TOWER_ACCELDELTA_CMD || command == TOWER_EXTENDED_CMD)
+    {
+      /*!the reply to TOWER_EXTENDED_CMD is a packet, its parameter2 and 3 are 0 where a frame's data would be*/
+      if (command != TOWER_EXTENDED_CMD || p[1] == EXTENDED_NB_DATA)
+        size = p[1] + 3;
+    }
+    if (nbBytes - used < size)
+      break;
+    for (i = 0; i < size - 1; i++)
+      checksum ^= p[i];
+    if (checksum != p[size - 1])
+    {
+      NbChecksumErrors++;
+      used++;
+      continue;
+    }
+    if (command == TOWER_EXTENDED_CMD && size == EXTENDED_NB_DATA + 3)
+      Extended(&p[2], now);
+    else
+      NbPackets++;
+    used += size;
+  }
+  return used;
+}
+
+/*! @brief Compares delays for qsort.
+ *
+ */
+static int Compare(const void *a, const void *b)
+{
+  int32_t x = *(const int32_t *)a, y = *(const int32_t *)b;
+
+  return (x > y) - (x < y);
+}
+
+/*! @brief Prints the counts and the latency histogram.
+ *
+ *  @return void
+ */
+static void Report(void)
+{
+  unsigned nbDelays = (NbFrames < MAX_NB_FRAMES) ? NbFrames : MAX_NB_FRAMES;
+  unsigned histogram[NB_BUCKETS] = {0};
+  unsigned i, b;
+  int32_t fastest;
+
+  printf("extended frames %u, other packets %u, checksum errors %u\n", NbFrames, NbPackets, NbChecksumErrors);
+  if (NbFrames == 0)
+    return;
+  printf("lost %u (%.2f%%), reordered or repeated %u\n", NbLost, 100.0 * NbLost / (NbFrames + NbLost), NbReordered);
+  for (i = 0; i < 256; i++)
+    if (NbByCommand[i])
+      printf("  command 0x%02X: %u frames\n", i, NbByCommand[i]);
+  qsort(Delays, nbDelays, sizeof(Delays[0]), Compare);
+  fastest = Delays[0];
+  for (i = 0; i < nbDelays; i++)
+  {
+    uint32_t latency = (uint32_t)(Delays[i] - fastest);
+
+    for (b = 0; latency > BucketLimits[b]; b++)
+      ;
+    histogram[b]++;
+  }
+  printf("latency beyond the quickest frame, us: median %d, 99%% %d, max %d\n",
+         Delays[nbDelays / 2] - fastest, Delays[nbDelays * 99 / 100] - fastest, Delays[nbDelays - 1] - fastest);
+  for (b = 0; b < NB_BUCKETS; b++)
+  {
+    if (b < NB_BUCKETS - 1)
+      printf("  <= %6u us %8u ", BucketLimits[b], histogram[b]);
+    else
+      printf("   > %6u us %8u ", BucketLimits[b - 1], histogram[b]);
+    for (i = 0; i < 50 * histogram[b] / nbDelays; i++)
+      putchar('#');
+    putchar('\n');
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  unsigned baudRate = (argc > 2) ? atoi(argv[2]) : 115200;
+  unsigned seconds = (argc > 3) ? atoi(argv[3]) : 10;
+  uint8_t buffer[4096];
+  size_t nbBytes = 0;
+  uint32_t start;
+  int fd;
+
+  if (argc < 2)
+  {
+    fprintf(stderr, "usage: %s device [baud rate] [seconds]\n", argv[0]);
+    return 1;
+  }
+  Delays = malloc(MAX_NB_FRAMES * sizeof(Delays[0]));
+  fd = Open(argv[1], baudRate);
+  if (!Delays || fd < 0)
+    return 1;
+  Put(fd, TOWER_EXTENDED_CMD, 1, 0, 0);
+  start = Microseconds();
+  while (Microseconds() - start < seconds * 1000000u)
+  {
+    struct timeval timeout = {0, 10000};
+    fd_set fds;
+    ssize_t n;
+    size_t used;
+
+    FD_ZERO(&fds);
+    FD_SET(fd, &fds);
+    if (select(fd + 1, &fds, NULL, NULL, &timeout) <= 0)
+      continue;
+    n = read(fd, &buffer[nbBytes], sizeof(buffer) - nbBytes);
+    if (n <= 0)
+      break;
+    nbBytes += n;
+    used = Frame(buffer, nbBytes, Microseconds());
+    memmove(buffer, &buffer[used], nbBytes - used);
+    nbBytes -= used;
+  }
+  Put(fd, TOWER_EXTENDED_CMD, 0, 0, 0);
+  close(fd);
+  Report();
+  return 0;
+}
+
+/* END TelemetryStats */
+/*!
+** @}
+*/
@@ -0,0 +1,127 @@
+/*! @file
+ *
+ *  @brief Virtual tower: the serial stack of the TWR-K70F120M running on a Linux PC.
+ *
+ *  FIFO.c, UART.c, packet.c, command.c and protocol.c are built unchanged against a simulated UART2 (HostUART.c)
+ *  that is wired to a pseudo-terminal, and a flash data storage in RAM (HostFlash.c). A PC client opens the
+ *  pty it prints, exactly as it would open the tower's serial port, to measure packets/sec, round trip
+ *  latency and behaviour under backlog without the hardware. The commands handled are the ones that only
+ *  need the serial stack, carried out by the same code as on the tower.
+ *
+ *  Build and run from the top of the repository:
+ *    gcc -std=gnu99 -O2 -IHost -ISources -o virtualtower Host/VirtualTower.c Host/HostUART.c Host/HostFlash.c Sources/FIFO.c Sources/UART.c Sources/packet.c Sources/command.c Sources/protocol.c Sources/CRC.c
+ *    ./virtualtower [accelerometer packets/sec]
+ *  Add -DPACKET_ISR_FRAMING=1 to frame packets in the simulated UART interrupt.
+ *  With a packet rate, accelerometer packets are sent as telemetry at that rate, to see how command
+ *  replies fare while the link is busy streaming.
+ *
+ *  @author Liang Wang
+ *  @date 2016-07-20
+ */
+/*!
+**  @addtogroup VirtualTower_module VirtualTower module documentation
+**  @{
+*/
+/* MODULE VirtualTower */
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "HostUART.h"
+#include "Cpu.h"
+#include "packet.h"
+#include "command.h"
+#include "Flash.h"
+#include "protocol.h"
+
+#define BAUDRATE 115200                               /*!<baud rate the tower starts at*/
+#define TOWER_ACCEL_CMD 0x10
+#define SLOT_ACCEL 1                                  /*!<telemetry slot of the accelerometer packets, as in main.c*/
+
+static volatile sig_atomic_t Running = 1;             /*!< cleared by Ctrl-C*/
+
+/*! @brief Gets the time in microseconds, in place of the PIT's count.
+ *
+ *  @return uint32_t - The microsecond count, wraps around after about 71 minutes.
+ */
+static uint32_t Microseconds(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)((uint64_t)now.tv_sec * 1000000u + now.tv_nsec / 1000);
+}
+
+/*! @brief Sends the accelerometer packets that are due, as the accelerometer interrupt would.
+ *
+ *  @param rate The number of packets per second.
+ *  @return void
+ */
+static void Tower_Stream(const unsigned rate)
+{
+  static struct timespec start;
+  static uint32_t nbSent = 0;
+  struct timespec now;
+  uint64_t nbDue;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  if (nbSent == 0 && start.tv_sec == 0)
+    start = now;
+  nbDue = ((uint64_t)(now.tv_sec - start.tv_sec) * 1000000000u + now.tv_nsec - start.tv_nsec) * rate / 1000000000u;
+  /*!only the newest reading is kept when the link cannot keep up, as on the tower*/
+  for (; nbSent < nbDue; nbSent++)
+    (void)Packet_PutLatest(SLOT_ACCEL, TOWER_ACCEL_CMD, nbSent & 0xFF, (nbSent >> 8) & 0xFF, 64);
+}
+
+/*! @brief Stops the main loop.
+ *
+ *  @param signal The signal number.
+ */
+static void Stop(int signal)
+{
+  (void)signal;
+  Running = 0;
+}
+
+int main(int argc, char *argv[])
+{
+  TProtocolSetup setup;
+  TUARTStats stats;
+  unsigned rate = (argc > 1) ? atoi(argv[1]) : 0;
+
+  if (!HostUART_Open())
+  {
+    perror("virtual tower: cannot open a pty");
+    return 1;
+  }
+  setup.startupFunction = Protocol_SendStartup;
+  setup.microsecondsFunction = Microseconds;
+  setup.receivedCallbackFunction = NULL;
+  if (!Packet_Init(BAUDRATE, CPU_BUS_CLK_HZ) || !Command_Init() || !Flash_Init() || !Protocol_Init(&setup))
+    return 1;
+  printf("virtual tower on %s at %d baud, %u accelerometer packets/s, Ctrl-C to stop\n", HostUART_Name(), BAUDRATE, rate);
+  fflush(stdout);
+  signal(SIGINT, Stop);
+  signal(SIGTERM, Stop);
+  (void)Protocol_SendStartup();
+
+  while (Running)
+  {
+    HostUART_Service();
+    Protocol_HandlePackets();
+    if (rate)
+      Tower_Stream(rate);
+  }
+
+  UART_GetStats(&stats);
+  printf("bytes in %u, bytes out %u, rx high water %u, rx dropped %u, tx high water %u, tx dropped %u\n",
+         stats.BytesIn, stats.BytesOut, stats.RxHighWater, stats.RxDropped, stats.TxHighWater, stats.TxDropped);
+  printf("packets dropped %u, checksum errors %u, received packets dropped %u, telemetry overwritten %u\n",
+         Packet_NbDropped(), Packet_NbChecksumErrors(), Packet_NbRxDropped(), Packet_NbOverwritten());
+  return 0;
+}
+
+/* END VirtualTower */
+/*!
+** @}
+*/
@@ -0,0 +1,37 @@
+/*! @file
+ *
+ *  @brief CRC-8 checksums.
+ *
+ *  This contains a table driven CRC-8 with the polynomial x^8 + x^2 + x + 1 (0x07), starting from 0. It is
+ *  reflected, bits are taken least significant first as the UART sends them, so that a burst on the line is
+ *  a burst to the CRC too. Over a 5-byte packet it detects every error of up to three bits and every burst
+ *  of up to eight, at the cost of one table lookup per byte.
+ *
+ *  @author Liang Wang
+ *  @date 2016-08-12
+ */
+
+#ifndef CRC_H
+#define CRC_H
+
+// New types
+#include "types.h"
+
+// Generator polynomial without its x^8 term, reflected: 0x07 read least significant bit first
+#define CRC_POLYNOMIAL8 0xE0
+
+// CRC of crc followed by the byte data
+#define CRC_UPDATE8(crc, data) (CRC_Table8[(uint8_t)((crc) ^ (data))])
+
+// CRC-8 of every byte value, in flash
+extern const uint8_t CRC_Table8[256];
+
+/*! @brief Works out the CRC-8 of a block of bytes.
+ *
+ *  @param data The bytes.
+ *  @param nbBytes The number of bytes.
+ *  @return uint8_t - The CRC-8.
+ */
+uint8_t CRC_8(const uint8_t* const data, const uint16_t nbBytes);
+
+#endif
@@ -1,55 +1,55 @@
-/* ###################################################################
-**     Filename    : Events.c
-**     Project     : Lab4
-**     Processor   : MK70FN1M0VMJ12
-**     Component   : Events
-**     Version     : Driver 01.00
-**     Compiler    : GNU C Compiler
-**     Date/Time   : 2016-05-28, 08:18, # CodeGen: 2
-**     Abstract    :
-**         This is user's event module.
-**         Put your event handler code here.
-**     Contents    :
-**         No public methods
-**
-** ###################################################################*/
-/*!
-** @file Events.c
-** @version 01.00
-** @brief
-**         This is user's event module.
-**         Put your event handler code here.
-*/         
-/*!
-**  @addtogroup Events_module Events module documentation
-**  @{
-*/         
-/* MODULE Events */
-
-#include "Cpu.h"
-#include "Events.h"
-
-#ifdef __cplusplus
-extern "C" {
-#endif 
-
-
-/* User includes (#include below this line is not maintained by Processor Expert) */
-
-/* END Events */
-
-#ifdef __cplusplus
-}  /* extern "C" */
-#endif 
-
-/*!
-** @}
-*/
-/*
-** ###################################################################
-**
-**     This file was created by Processor Expert 10.5 [05.21]
-**     for the Freescale Kinetis series of microcontrollers.
-**
-** ###################################################################
-*/
+/* ###################################################################
+**     Filename    : Events.c
+**     Project     : Lab4
+**     Processor   : MK70FN1M0VMJ12
+**     Component   : Events
+**     Version     : Driver 01.00
+**     Compiler    : GNU C Compiler
+**     Date/Time   : 2016-05-28, 08:18, # CodeGen: 2
+**     Abstract    :
+**         This is user's event module.
+**         Put your event handler code here.
+**     Contents    :
+**         No public methods
+**
+** ###################################################################*/
+/*!
+** @file Events.c
+** @version 01.00
+** @brief
+**         This is user's event module.
+**         Put your event handler code here.
+*/         
+/*!
+**  @addtogroup Events_module Events module documentation
+**  @{
+*/         
+/* MODULE Events */
+
+#include "Cpu.h"
+#include "Events.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif 
+
+
+/* User includes (#include below this line is not maintained by Processor Expert) */
+
+/* END Events */
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif 
+
+/*!
+** @}
+*/
+/*
+** ###################################################################
+**
+**     This file was created by Processor Expert 10.5 [05.21]
+**     for the Freescale Kinetis series of microcontrollers.
+**
+** ###################################################################
+*/
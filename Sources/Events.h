@@ -1,60 +1,60 @@
-/* ###################################################################
-**     Filename    : Events.h
-**     Project     : Lab4
-**     Processor   : MK70FN1M0VMJ12
-**     Component   : Events
-**     Version     : Driver 01.00
-**     Compiler    : GNU C Compiler
-**     Date/Time   : 2016-05-28, 08:18, # CodeGen: 2
-**     Abstract    :
-**         This is user's event module.
-**         Put your event handler code here.
-**     Contents    :
-**         No public methods
-**
-** ###################################################################*/
-/*!
-** @file Events.h
-** @version 01.00
-** @brief
-**         This is user's event module.
-**         Put your event handler code here.
-*/         
-/*!
-**  @addtogroup Events_module Events module documentation
-**  @{
-*/         
-
-#ifndef __Events_H
-#define __Events_H
-/* MODULE Events */
-
-#include "PE_Types.h"
-#include "PE_Error.h"
-#include "PE_Const.h"
-#include "IO_Map.h"
-
-#ifdef __cplusplus
-extern "C" {
-#endif 
-
-
-/* END Events */
-
-#ifdef __cplusplus
-}  /* extern "C" */
-#endif 
-
-#endif 
-/* ifndef __Events_H*/
-/*!
-** @}
-*/
-/*
-** ###################################################################
-**
-**     This file was created by Processor Expert 10.5 [05.21]
-**     for the Freescale Kinetis series of microcontrollers.
-**
-** ###################################################################
-*/
+/* ###################################################################
+**     Filename    : Events.h
+**     Project     : Lab4
+**     Processor   : MK70FN1M0VMJ12
+**     Component   : Events
+**     Version     : Driver 01.00
+**     Compiler    : GNU C Compiler
+**     Date/Time   : 2016-05-28, 08:18, # CodeGen: 2
+**     Abstract    :
+**         This is user's event module.
+**         Put your event handler code here.
+**     Contents    :
+**         No public methods
+**
+** ###################################################################*/
+/*!
+** @file Events.h
+** @version 01.00
+** @brief
+**         This is user's event module.
+**         Put your event handler code here.
+*/         
+/*!
+**  @addtogroup Events_module Events module documentation
+**  @{
+*/         
+
+#ifndef __Events_H
+#define __Events_H
+/* MODULE Events */
+
+#include "PE_Types.h"
+#include "PE_Error.h"
+#include "PE_Const.h"
+#include "IO_Map.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif 
+
+
+/* END Events */
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif 
+
+#endif 
+/* ifndef __Events_H*/
+/*!
+** @}
+*/
+/*
+** ###################################################################
+**
+**     This file was created by Processor Expert 10.5 [05.21]
+**     for the Freescale Kinetis series of microcontrollers.
+**
+** ###################################################################
+*/
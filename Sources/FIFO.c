@@ -1,93 +1,233 @@
-/*! @file
- *
- *  @brief FIFO module :Routines to implement a FIFO buffer.
- *
- *  This module contains the structure and "methods" for accessing a byte-wide FIFO.
- *
- *  @author Liang Wang
- *  @date 2016-06-10
- */
-/*!
-**  @addtogroup FIFO_module FIFO module documentation
-**  @{
-*/
-/* MODULE FIFO */
-#include "FIFO.h"
-
-
-void FIFO_Init(TFIFO * const FIFO)
-{
-  /*! initial the value*/
-  /*initial the index of the position of the oldest data in the FIFO*/
-  FIFO->Start = 0;
-
-  /* initial the index of the next available empty position in the FIFO*/
-  FIFO->End = 0;
-
-  /*initial the number of bytes currently stored in the FIFO*/
-  FIFO->NbBytes = 0;
-}
-
-
-BOOL FIFO_Put(TFIFO * const FIFO, const uint8_t data)
-{
-  /*!save status register and disable interrupt*/
-  EnterCritical();
-  /*make sure if FIFO is full,if it's full,data will not be stored*/
-  if (FIFO->NbBytes == FIFO_SIZE)
-    {
-    /*!restore status register*/
-    ExitCritical();
-    return bFALSE;
-    }
-  /*if FIFO is not full store data*/
-  else
-  {
-    /*store data in the next available empty position of the actual array of bytes*/
-    FIFO->Buffer[FIFO->End] = data;
-    /*when we stored a data FIFO->End++*/
-    FIFO->End++;
-    /*until it equal to 255, FIFO is full, so FIFO->End backs to 0 instead of equal to 256*/
-    if (FIFO->End == FIFO_SIZE)
-      FIFO->End = 0;
-    /*when a data stored in FIFO,this means current stored data plus one*/
-      FIFO->NbBytes ++;
-    /*!restore status register*/
-      ExitCritical();
-      return bTRUE;
-  }
-}
-
-
-BOOL FIFO_Get(TFIFO * const FIFO, uint8_t * const dataPtr)
-{
-  /*!save status register and disable interrupt*/
-  EnterCritical();
-  /*make sure FIFO is not empty, if it's empty, return bFALSE*/
-  if (FIFO->NbBytes == 0)
-    {
-      /*!restore status register*/
-      ExitCritical();
-      return bFALSE;
-    }
-  /*if FIFO is not empty, take out it*/
-  else
-  {
-    /*the oldest data in the current array is put in the position where the dataPtr point*/
-    *dataPtr = FIFO->Buffer[FIFO->Start];
-    /*when a data is taken out of FIFO, FIFO->Start++*/
-    FIFO->Start++;
-    /*until it equal to 255, FIFO is empty, FIFO->End backs to 0 instead of equal to 256*/
-    if (FIFO->Start == FIFO_SIZE)
-      FIFO->Start = 0;
-      /*when a data is get,this means current stored data minus one*/
-      FIFO->NbBytes --;
-      /*!restore status register*/
-      ExitCritical();
-      return bTRUE;
-  }
-}
-/* END FIFO */
-/*!
-** @}
-*/
+/*! @file
+ *
+ *  @brief FIFO module :Routines to implement a FIFO buffer.
+ *
+ *  This module contains the structure and "methods" for accessing a byte-wide FIFO.
+ *
+ *  @author Liang Wang
+ *  @date 2016-06-10
+ */
+/*!
+**  @addtogroup FIFO_module FIFO module documentation
+**  @{
+*/
+/* MODULE FIFO */
+#include <string.h>
+#include "FIFO.h"
+
+void FIFO_Init(TFIFO * const FIFO, uint8_t * const buffer, const uint16_t size)
+{
+  /*! initial the value*/
+  /*the buffer size is a power of two, so the indices wrap by masking with size - 1*/
+  FIFO->Buffer = buffer;
+  FIFO->Mask = size - 1;
+
+  /*initial the index of the position of the oldest data in the FIFO*/
+  FIFO->Start = 0;
+
+  /* initial the index of the next available empty position in the FIFO*/
+  FIFO->End = 0;
+
+  /*initial the number of bytes currently stored in the FIFO*/
+  FIFO->NbBytes = 0;
+
+  /*nothing has been reserved yet*/
+  FIFO->Reserved = 0;
+
+  /*nothing has been stored or refused yet*/
+  FIFO->HighWater = 0;
+  FIFO->NbDropped = 0;
+}
+
+
+BOOL FIFO_Put(TFIFO * const FIFO, const uint8_t data)
+{
+  /*!save status register and disable interrupt*/
+  EnterCritical();
+  /*make sure if FIFO is full,if it's full,data will not be stored;
+    a reservation owns the positions after FIFO->End, so nothing can be stored there either*/
+  if (FIFO->NbBytes > FIFO->Mask || FIFO->Reserved)
+    {
+    FIFO->NbDropped++;
+    /*!restore status register*/
+    ExitCritical();
+    return bFALSE;
+    }
+  /*if FIFO is not full store data*/
+  else
+  {
+    /*store data in the next available empty position of the actual array of bytes*/
+    FIFO->Buffer[FIFO->End] = data;
+    /*when we stored a data FIFO->End++, the mask takes it back to 0 when it passes the end*/
+    FIFO->End = (FIFO->End + 1) & FIFO->Mask;
+    /*when a data stored in FIFO,this means current stored data plus one*/
+      FIFO->NbBytes ++;
+    if (FIFO->NbBytes > FIFO->HighWater)
+      FIFO->HighWater = FIFO->NbBytes;
+    /*!restore status register*/
+      ExitCritical();
+      return bTRUE;
+  }
+}
+
+
+BOOL FIFO_Get(TFIFO * const FIFO, uint8_t * const dataPtr)
+{
+  /*!save status register and disable interrupt*/
+  EnterCritical();
+  /*make sure FIFO is not empty, if it's empty, return bFALSE*/
+  if (FIFO->NbBytes == 0)
+    {
+      /*!restore status register*/
+      ExitCritical();
+      return bFALSE;
+    }
+  /*if FIFO is not empty, take out it*/
+  else
+  {
+    /*the oldest data in the current array is put in the position where the dataPtr point*/
+    *dataPtr = FIFO->Buffer[FIFO->Start];
+    /*when a data is taken out of FIFO, FIFO->Start++, the mask takes it back to 0 when it passes the end*/
+    FIFO->Start = (FIFO->Start + 1) & FIFO->Mask;
+      /*when a data is get,this means current stored data minus one*/
+      FIFO->NbBytes --;
+      /*!restore status register*/
+      ExitCritical();
+      return bTRUE;
+  }
+}
+
+
+BOOL FIFO_PutBlock(TFIFO * const FIFO, const uint8_t * const data, const uint16_t nbBytes)
+{
+  uint16_t first;    /*number of bytes that fit before the end of the buffer*/
+
+  /*!save status register and disable interrupt, once for the whole block*/
+  EnterCritical();
+  /*the block is stored all or nothing, so make sure all of it fits and nothing is reserved after FIFO->End*/
+  if (nbBytes > FIFO->Mask + 1 - FIFO->NbBytes || FIFO->Reserved)
+  {
+    FIFO->NbDropped++;
+    /*!restore status register*/
+    ExitCritical();
+    return bFALSE;
+  }
+  /*copy up to the end of the buffer, then the rest from the start of the buffer*/
+  first = FIFO->Mask + 1 - FIFO->End;
+  if (first > nbBytes)
+    first = nbBytes;
+  memcpy(&FIFO->Buffer[FIFO->End], data, first);
+  memcpy(FIFO->Buffer, data + first, nbBytes - first);
+  /*move FIFO->End past the block, going back to the start when it passes the end*/
+  FIFO->End = (FIFO->End + nbBytes) & FIFO->Mask;
+  FIFO->NbBytes += nbBytes;
+  if (FIFO->NbBytes > FIFO->HighWater)
+    FIFO->HighWater = FIFO->NbBytes;
+  /*!restore status register*/
+  ExitCritical();
+  return bTRUE;
+}
+
+
+BOOL FIFO_GetBlock(TFIFO * const FIFO, uint8_t * const dataPtr, const uint16_t nbBytes)
+{
+  uint16_t first;    /*number of bytes that can be read before the end of the buffer*/
+
+  /*!save status register and disable interrupt, once for the whole block*/
+  EnterCritical();
+  /*the block is retrieved all or nothing, so make sure all of it is there*/
+  if (nbBytes > FIFO->NbBytes)
+  {
+    /*!restore status register*/
+    ExitCritical();
+    return bFALSE;
+  }
+  /*copy up to the end of the buffer, then the rest from the start of the buffer*/
+  first = FIFO->Mask + 1 - FIFO->Start;
+  if (first > nbBytes)
+    first = nbBytes;
+  memcpy(dataPtr, &FIFO->Buffer[FIFO->Start], first);
+  memcpy(dataPtr + first, FIFO->Buffer, nbBytes - first);
+  /*move FIFO->Start past the block, going back to the start when it passes the end*/
+  FIFO->Start = (FIFO->Start + nbBytes) & FIFO->Mask;
+  FIFO->NbBytes -= nbBytes;
+  /*!restore status register*/
+  ExitCritical();
+  return bTRUE;
+}
+
+
+BOOL FIFO_Reserve(TFIFO * const FIFO, const uint16_t nbBytes, TFIFOSpan * const span)
+{
+  /*!save status register and disable interrupt*/
+  EnterCritical();
+  /*only one reservation at a time, and all of it has to fit*/
+  if (FIFO->Reserved || nbBytes == 0 || nbBytes > FIFO->Mask + 1 - FIFO->NbBytes)
+  {
+    FIFO->NbDropped++;
+    /*!restore status register*/
+    ExitCritical();
+    return bFALSE;
+  }
+  /*the first part runs from FIFO->End up to the end of the buffer, the rest wraps to the start*/
+  span->Data1 = &FIFO->Buffer[FIFO->End];
+  span->Size1 = FIFO->Mask + 1 - FIFO->End;
+  if (span->Size1 > nbBytes)
+    span->Size1 = nbBytes;
+  span->Data2 = FIFO->Buffer;
+  span->Size2 = nbBytes - span->Size1;
+  FIFO->Reserved = nbBytes;
+  /*!restore status register*/
+  ExitCritical();
+  return bTRUE;
+}
+
+
+void FIFO_Commit(TFIFO * const FIFO, const uint16_t nbBytes)
+{
+  /*!save status register and disable interrupt*/
+  EnterCritical();
+  /*move FIFO->End past the committed bytes, going back to the start when it passes the end*/
+  FIFO->End = (FIFO->End + nbBytes) & FIFO->Mask;
+  /*the committed bytes become visible to FIFO_Get all at once*/
+  FIFO->NbBytes += nbBytes;
+  if (FIFO->NbBytes > FIFO->HighWater)
+    FIFO->HighWater = FIFO->NbBytes;
+  /*whatever was not committed is given back*/
+  FIFO->Reserved = 0;
+  /*!restore status register*/
+  ExitCritical();
+}
+
+
+uint16_t FIFO_Peek(TFIFO * const FIFO, uint8_t ** const dataPtr)
+{
+  uint16_t nbBytes;  /*number of bytes stored from FIFO->Start up to the end of the buffer*/
+
+  /*!save status register and disable interrupt*/
+  EnterCritical();
+  *dataPtr = &FIFO->Buffer[FIFO->Start];
+  nbBytes = FIFO->Mask + 1 - FIFO->Start;
+  if (nbBytes > FIFO->NbBytes)
+    nbBytes = FIFO->NbBytes;
+  /*!restore status register*/
+  ExitCritical();
+  return nbBytes;
+}
+
+
+void FIFO_Release(TFIFO * const FIFO, const uint16_t nbBytes)
+{
+  /*!save status register and disable interrupt*/
+  EnterCritical();
+  /*move FIFO->Start past the used bytes, only now can the producers store over them*/
+  FIFO->Start = (FIFO->Start + nbBytes) & FIFO->Mask;
+  FIFO->NbBytes -= nbBytes;
+  /*!restore status register*/
+  ExitCritical();
+}
+
+/* END FIFO */
+/*!
+** @}
+*/
@@ -1,57 +1,208 @@
-/*! @file
- *
- *  @brief Routines to implement a FIFO buffer.
- *
- *  This contains the structure and "methods" for accessing a byte-wide FIFO.
- *
- *  @author PMcL
- *  @date 2015-07-23
- */
-
-#ifndef FIFO_H
-#define FIFO_H
-
-// new types
-#include "types.h"
-#include "PE_Types.h"
-#include "Cpu.h"
-// Number of bytes in a FIFO
-#define FIFO_SIZE 256
-
-/*!
- * @struct TFIFO
- */
-typedef struct
-{
-  uint16_t Start;		/*!< The index of the position of the oldest data in the FIFO */
-  uint16_t End; 		/*!< The index of the next available empty position in the FIFO */
-  uint16_t volatile NbBytes;	/*!< The number of bytes currently stored in the FIFO */
-  uint8_t Buffer[FIFO_SIZE];	/*!< The actual array of bytes to store the data */
-} TFIFO;
-
-/*! @brief Initialize the FIFO before first use.
- *
- *  @param FIFO A pointer to the FIFO that needs initializing.
- *  @return void
- */
-void FIFO_Init(TFIFO* const FIFO);
-
-/*! @brief Put one character into the FIFO.
- *
- *  @param FIFO A pointer to a FIFO struct where data is to be stored.
- *  @param data A byte of data to store in the FIFO buffer.
- *  @return BOOL - TRUE if data is successfully stored in the FIFO.
- *  @note Assumes that FIFO_Init has been called.
- */
-BOOL FIFO_Put(TFIFO* const FIFO, const uint8_t data);
-
-/*! @brief Get one character from the FIFO.
- *
- *  @param FIFO A pointer to a FIFO struct with data to be retrieved.
- *  @param dataPtr A pointer to a memory location to place the retrieved byte.
- *  @return BOOL - TRUE if data is successfully retrieved from the FIFO.
- *  @note Assumes that FIFO_Init has been called.
- */
-BOOL FIFO_Get(TFIFO* const FIFO, uint8_t* const dataPtr);
-
-#endif
+/*! @file
+ *
+ *  @brief Routines to implement a FIFO buffer.
+ *
+ *  This contains the structure and "methods" for accessing a byte-wide FIFO,
+ *  and a macro that defines FIFOs of other element types.
+ *
+ *  @author PMcL
+ *  @date 2015-07-23
+ */
+
+#ifndef FIFO_H
+#define FIFO_H
+
+// new types
+#include "types.h"
+#include "PE_Types.h"
+#include "Cpu.h"
+
+// Orders the buffer access against the index update seen by the other side of a single-producer/single-consumer FIFO
+#define FIFO_MEMORY_BARRIER() __sync_synchronize()
+
+// Fails to compile unless size is a power of two that free running 16-bit indices can count up to
+#define FIFO_CHECK_SIZE(name, size) \
+  typedef char name##_SizeIsAPowerOfTwo[((size) > 0 && ((size) & ((size) - 1)) == 0 && (size) <= 32768) ? 1 : -1]
+
+// Declares the byte array for a TFIFO, the size is fixed at compile time and must be a power of two
+#define FIFO_BUFFER(name, size) \
+  FIFO_CHECK_SIZE(name, size); \
+  static uint8_t name[(size)]
+
+/*!
+ * @struct TFIFO
+ */
+typedef struct
+{
+  uint16_t Start;		/*!< The index of the position of the oldest data in the FIFO */
+  uint16_t End; 		/*!< The index of the next available empty position in the FIFO */
+  uint16_t volatile NbBytes;	/*!< The number of bytes currently stored in the FIFO */
+  uint16_t Reserved;		/*!< The number of bytes after End handed out by FIFO_Reserve and not yet committed */
+  uint16_t Mask;		/*!< The size of the buffer minus one, used to wrap the indices */
+  uint16_t HighWater;		/*!< The most bytes the FIFO has held since it was initialized */
+  uint16_t NbDropped;		/*!< The number of puts and reservations refused, wraps around at 65536 */
+  uint8_t* Buffer;		/*!< The actual array of bytes to store the data, declared with FIFO_BUFFER */
+} TFIFO;
+
+/*!
+ * @struct TFIFOSpan
+ */
+typedef struct
+{
+  uint8_t* Data1;		/*!< The start of the first contiguous part of the span */
+  uint16_t Size1;		/*!< The number of bytes in the first part */
+  uint8_t* Data2;		/*!< The start of the part that wrapped around to the beginning of the buffer */
+  uint16_t Size2;		/*!< The number of bytes in the second part, 0 if the span did not wrap */
+} TFIFOSpan;
+
+// Address of the byte at position index of a span handed out by FIFO_Reserve
+#define FIFO_SPAN_AT(span, index) \
+  ((index) < (span)->Size1 ? &(span)->Data1[(index)] : &(span)->Data2[(index) - (span)->Size1])
+
+/*! @brief Defines a FIFO type, and its "methods", for elements of any type.
+ *
+ *  FIFO_DEFINE(Name, ElementType, Size) declares the type TName and the functions
+ *  Name_Init, Name_Put, Name_Get and Name_NbItems, local to the file that uses it.
+ *  Size is fixed at compile time and must be a power of two, so the indices wrap with a mask.
+ *  Each index is only written by one side, so a single producer and a single consumer,
+ *  e.g. an interrupt and the main loop, can share the FIFO without disabling interrupts.
+ */
+#define FIFO_DEFINE(Name, ElementType, Size) \
+FIFO_CHECK_SIZE(Name, Size); \
+typedef struct \
+{ \
+  uint16_t volatile Head;	/* The free running index of the next empty position, only written by the producer */ \
+  uint16_t volatile Tail;	/* The free running index of the oldest element, only written by the consumer */ \
+  ElementType Buffer[(Size)];	/* The actual array of elements */ \
+} T##Name; \
+\
+static void __attribute__ ((unused)) Name##_Init(T##Name* const FIFO) \
+{ \
+  FIFO->Head = 0; \
+  FIFO->Tail = 0; \
+} \
+\
+static uint16_t __attribute__ ((unused)) Name##_NbItems(const T##Name* const FIFO) \
+{ \
+  return (uint16_t)(FIFO->Head - FIFO->Tail); \
+} \
+\
+static BOOL __attribute__ ((unused)) Name##_Put(T##Name* const FIFO, const ElementType* const data) \
+{ \
+  uint16_t head = FIFO->Head; \
+  /* Tail may only grow behind our back, which can only make the FIFO look fuller than it is */ \
+  if ((uint16_t)(head - FIFO->Tail) == (Size)) \
+    return bFALSE; \
+  FIFO->Buffer[head & ((Size) - 1)] = *data; \
+  /* the element must be in the buffer before the consumer can see the new Head */ \
+  FIFO_MEMORY_BARRIER(); \
+  FIFO->Head = head + 1; \
+  return bTRUE; \
+} \
+\
+static BOOL __attribute__ ((unused)) Name##_Get(T##Name* const FIFO, ElementType* const dataPtr) \
+{ \
+  uint16_t tail = FIFO->Tail; \
+  /* Head may only grow behind our back, which can only make the FIFO look emptier than it is */ \
+  if (FIFO->Head == tail) \
+    return bFALSE; \
+  /* do not read the buffer before Head was seen to cover it */ \
+  FIFO_MEMORY_BARRIER(); \
+  *dataPtr = FIFO->Buffer[tail & ((Size) - 1)]; \
+  /* the element must be read out before the producer can reuse its position */ \
+  FIFO_MEMORY_BARRIER(); \
+  FIFO->Tail = tail + 1; \
+  return bTRUE; \
+}
+
+/*! @brief Initialize the FIFO before first use.
+ *
+ *  @param FIFO A pointer to the FIFO that needs initializing.
+ *  @param buffer The array of bytes declared with FIFO_BUFFER that the FIFO stores its data in.
+ *  @param size The number of bytes in buffer, a power of two.
+ *  @return void
+ */
+void FIFO_Init(TFIFO* const FIFO, uint8_t* const buffer, const uint16_t size);
+
+/*! @brief Put one character into the FIFO.
+ *
+ *  @param FIFO A pointer to a FIFO struct where data is to be stored.
+ *  @param data A byte of data to store in the FIFO buffer.
+ *  @return BOOL - TRUE if data is successfully stored in the FIFO, FALSE if it is full or has a reservation.
+ *  @note Assumes that FIFO_Init has been called.
+ */
+BOOL FIFO_Put(TFIFO* const FIFO, const uint8_t data);
+
+/*! @brief Get one character from the FIFO.
+ *
+ *  @param FIFO A pointer to a FIFO struct with data to be retrieved.
+ *  @param dataPtr A pointer to a memory location to place the retrieved byte.
+ *  @return BOOL - TRUE if data is successfully retrieved from the FIFO.
+ *  @note Assumes that FIFO_Init has been called.
+ */
+BOOL FIFO_Get(TFIFO* const FIFO, uint8_t* const dataPtr);
+
+/*! @brief Put a block of characters into the FIFO.
+ *
+ *  The block is stored in one go, or not at all if there is not enough room for all of it.
+ *  @param FIFO A pointer to a FIFO struct where data is to be stored.
+ *  @param data A pointer to the bytes to store in the FIFO buffer.
+ *  @param nbBytes The number of bytes to store.
+ *  @return BOOL - TRUE if the whole block is successfully stored in the FIFO, FALSE if it does not fit or the FIFO has a reservation.
+ *  @note Assumes that FIFO_Init has been called.
+ */
+BOOL FIFO_PutBlock(TFIFO* const FIFO, const uint8_t* const data, const uint16_t nbBytes);
+
+/*! @brief Get a block of characters from the FIFO.
+ *
+ *  The block is retrieved in one go, or not at all if the FIFO holds fewer bytes than asked for.
+ *  @param FIFO A pointer to a FIFO struct with data to be retrieved.
+ *  @param dataPtr A pointer to a memory location to place the retrieved bytes.
+ *  @param nbBytes The number of bytes to retrieve.
+ *  @return BOOL - TRUE if the whole block is successfully retrieved from the FIFO.
+ *  @note Assumes that FIFO_Init has been called.
+ */
+BOOL FIFO_GetBlock(TFIFO* const FIFO, uint8_t* const dataPtr, const uint16_t nbBytes);
+
+/*! @brief Reserve room in the FIFO so that data can be written straight into its buffer.
+ *
+ *  The reserved bytes cannot be seen by FIFO_Get until they are committed with FIFO_Commit.
+ *  Only one reservation can be outstanding at a time, and FIFO_Put and FIFO_PutBlock fail while it is.
+ *  @param FIFO A pointer to a FIFO struct where data is to be stored.
+ *  @param nbBytes The number of bytes to reserve.
+ *  @param span A pointer to a span that is set to the one or two parts of the buffer that were reserved.
+ *  @return BOOL - TRUE if the room was reserved, FALSE if the FIFO is too full or already has a reservation.
+ *  @note Assumes that FIFO_Init has been called.
+ */
+BOOL FIFO_Reserve(TFIFO* const FIFO, const uint16_t nbBytes, TFIFOSpan* const span);
+
+/*! @brief Commit the bytes written into a reservation so that they can be retrieved.
+ *
+ *  Any reserved bytes that are not committed are given back to the FIFO.
+ *  @param FIFO A pointer to a FIFO struct with an outstanding reservation.
+ *  @param nbBytes The number of bytes to commit from the start of the reservation, 0 to cancel it.
+ *  @return void
+ *  @note Assumes that FIFO_Reserve has been called and that nbBytes is not more than was reserved.
+ */
+void FIFO_Commit(TFIFO* const FIFO, const uint16_t nbBytes);
+
+/*! @brief Find the oldest bytes in the FIFO that are stored contiguously, without taking them out.
+ *
+ *  This lets e.g. a DMA transfer read straight from the buffer; the bytes stay owned by the FIFO until FIFO_Release.
+ *  @param FIFO A pointer to a FIFO struct with data to be retrieved.
+ *  @param dataPtr A pointer to a pointer that is set to the oldest byte in the FIFO.
+ *  @return uint16_t - The number of bytes stored contiguously from *dataPtr, 0 if the FIFO is empty.
+ *  @note Assumes that FIFO_Init has been called and that there is only one context getting from the FIFO.
+ */
+uint16_t FIFO_Peek(TFIFO* const FIFO, uint8_t** const dataPtr);
+
+/*! @brief Take bytes found with FIFO_Peek out of the FIFO once they have been used.
+ *
+ *  @param FIFO A pointer to a FIFO struct with data that was peeked at.
+ *  @param nbBytes The number of bytes to take out, not more than FIFO_Peek returned.
+ *  @return void
+ *  @note Assumes that FIFO_Peek has been called.
+ */
+void FIFO_Release(TFIFO* const FIFO, const uint16_t nbBytes);
+
+#endif
@@ -1,224 +1,455 @@
-/*! @file
- *
- *  @brief Flash module: Routines for erasing and writing to the Flash.
- *
- *  This module contains the functions needed for accessing the internal Flash.
- *
- *  @author Liang Wang
- *  @date 2016-06-10
- */
-/*!
-**  @addtogroup Flash_module Flash module documentation
-**  @{
-*/
-/* MODULE Flash */
-#include "Flash.h"
-
-#define FIRST_ADDRESS                0x00080000            /*!<  a FIRST_ADDRESS and give it value */
-#define LAST_ADDRESS                 0x00080008            /*!<  a LAST_ADDRESS and give it value */
-#define LAST_AVALIABLE_SIZE2_ADDRESS 0x80006               /*!<  a LAST_AVALIABLE_SIZE2_ADDRESS and give it value */
-#define LAST_AVALIABLE_SIZE4_ADDRESS 0x80004               /*!<  LAST_AVALIABLE_SIZE4_ADDRESS and give it value */
-static int ptrAdd= FIRST_ADDRESS;                          /*!<  a local variable */
-
-BOOL Flash_Init(void)
-{
-  /*enable the flash memory gate*/
-  SIM_SCGC3 |= SIM_SCGC3_NFC_MASK;
-  return bTRUE;
-}
-
-
-BOOL Flash_AllocateVar(volatile void **variable, const uint8_t size)
-{
-  /* align flash address. */
-  if(ptrAdd>LAST_ADDRESS)
-    ptrAdd = FIRST_ADDRESS;
-  if(size == 2)
-  {
-    if(ptrAdd>LAST_AVALIABLE_SIZE2_ADDRESS)
-      ptrAdd = FIRST_ADDRESS;
-    ptrAdd +=(ptrAdd%2);
-  }
-  if(size == 4 && ptrAdd%4!=0)
-  {
-    if(ptrAdd >LAST_AVALIABLE_SIZE4_ADDRESS)
-      ptrAdd = FIRST_ADDRESS;
-    ptrAdd =ptrAdd+ 4 - (ptrAdd%4);
-  }
-  /*give the data on ptrAdd to the position of the pointer point to */
-  *variable= (int *)ptrAdd;
-  /*allocate address to the next data, if size is 2, and the first address is 0x80000,the the next address is 0x80002*/
-  ptrAdd +=size;
-  return bTRUE;
-}
-
-
-/*! @brief copy the data that we have changed  in ram buffer back into flash.
- *
- *  @return BOOL - TRUE if data is written to flash successfully.
- */
-BOOL Flash_RamToFlash(uint8_t ram[])
-{
-  uint8_t CCIFflag, ACCERRflag, FPVIOLflag;  /*!< CCIFflag, ACCERRflag, FPVIOLflag local variables*/
-
-  /*!after the old flash memory erased, copy the new one into it*/
-  if(Flash_Erase())
-  {
-    for(;;)
-    {
-      /* check if CCIF is 1,use mask to make it equal to x first and others 0*/
-      CCIFflag = FTFE_FSTAT & FTFE_FSTAT_CCIF_MASK;
-      /*when x=1,which means CCIF is 1*/
-      if(CCIFflag == FTFE_FSTAT_CCIF_MASK)
-      {
-        /*check if ACCERR and FPVIOL are both equal to 1,use mask to make them equal to x first and others 0*/
-        ACCERRflag = FTFE_FSTAT &FTFE_FSTAT_ACCERR_MASK;
-        FPVIOLflag = FTFE_FSTAT &FTFE_FSTAT_FPVIOL_MASK;
-        /*when x=1,which means they are 1*/
-        if(ACCERRflag == FTFE_FSTAT_ACCERR_MASK && FPVIOLflag == FTFE_FSTAT_FPVIOL_MASK)
-	{
-          /*clear the old errors and write 0x30 to FSTAT register*/
-	  FTFE_FSTAT = 0x30;
-	}
-        /*write to the FCCOB register to load the required command parameter
-        do write data follow the pin name of FCCOB*/
-	FTFE_FCCOB0 = 0x07;
-	/*follow the first address0x080000*/
-	FTFE_FCCOB1 = 0x08;
-	FTFE_FCCOB2 = 0x00;
-	FTFE_FCCOB3 = 0x00;
-	/*copy the data changed in ram buffer back into flash, follow THE typedef structure FTFE_MemMap inMK70F12,h*/
-	FTFE_FCCOB7 = ram[0];
-	FTFE_FCCOB6 = ram[1];
-	FTFE_FCCOB5 = ram[2];
-	FTFE_FCCOB4 = ram[3];
-	FTFE_FCCOBB = ram[4];
-	FTFE_FCCOBA = ram[5];
-	FTFE_FCCOB9 = ram[6];
-	FTFE_FCCOB8 = ram[7];
-	/*clear the CCIF to launch the command write 0x80 to FSTAT register*/
-	FTFE_FSTAT = 0x80;
-	return bTRUE;
-      }
-    }
-  }
-}
-
-BOOL Flash_Write32(uint32_t volatile * const address, const uint32_t data)
-{
-  TFloat data32;       /* a 32 bits data*/
-
-  data32.d = data;     /*Separate 32 bit four 8 bit number*/
-
-  int i = 0;           /*i to make a loop*/
-
-  int startWriteAdd;   /*a ram address for each eight bit*/
-
-  uint8_t ram[8];      /*each ram has eight bits*/
-
-  /*!copy the data from flash into a ram buffer by each byte*/
-  for(i;i<=7;i++)
-  {
-    ram[i] = *((uint32_t *)(FIRST_ADDRESS+i));
-  }
-  /*!get the address than change the data of that address in the buffer*/
-  startWriteAdd = (uint32_t)address;
-  /*!change the data each byte in ram buffer*/
-  ram[startWriteAdd] =data32.dParts.dHi.s.Hi;
-  ram[startWriteAdd+1] =data32.dParts.dHi.s.Lo;
-  ram[startWriteAdd+2] =data32.dParts.dLo.s.Hi;
-  ram[startWriteAdd+3] =data32.dParts.dLo.s.Lo;
-  /*!copy the changed data from ram buffer back to flash*/
-  return Flash_RamToFlash(ram);
-}
-
-
-BOOL Flash_Write16(uint16_t volatile * const address, const uint16_t data)
-{
-  uint16union_t data16;     /* a 16 bits data*/
-
-  data16.l = data;          /*Separate 16 bits to two 8 bit number*/
-
-  int i = 0;                /* i to make a loop*/
-
-  int startWriteAdd;        /* a ram address for each eight bit*/
-
-  uint8_t ram[8];           /*each ram has eight bits*/
-
-  for(i;i<=7;i++)
-  {
-    /*copy the data from flash into a ram buffer by each byte*/
-    ram[i] = *((uint32_t *)(FIRST_ADDRESS+i));
-  }
-  /* change the data in ram buffer by finding the address offset*/
-  startWriteAdd = (uint32_t)address- FIRST_ADDRESS;
-  /*change the data by each byte in ram buffer*/
-  ram[startWriteAdd] =data16.s.Lo;
-  ram[startWriteAdd+1] =data16.s.Hi;
-  /*copy the changed data from ram buffer back to flash*/
-  return Flash_RamToFlash(ram);
-}
-
-
-BOOL Flash_Write8(uint8_t volatile * const address, const uint8_t data)
-{
-  int i = 0;               /* i to make a loop*/
-
-  int startWriteAdd;       /* a ram address for each eight bit*/
-
-  uint8_t ram[8];          /*each ram has eight bits*/
-
-  /*copy the data from flash into a ram buffer by each byte*/
-  for(i;i<=7;i++)
-  {
-    ram[i] = *((uint32_t *)(FIRST_ADDRESS+i));
-  }
-  /*get the address that we want to change the data*/
-  startWriteAdd=(uint32_t)address;
-  /*do change the data in the right address in ram buffer*/
-  ram[startWriteAdd] =data;
-  /*copy the changed data from ram buffer back to flash*/
-  return Flash_RamToFlash(ram);
-}
-
-
-BOOL Flash_Erase(void)
-{
-  uint8_t CCIFflag, ACCERRflag, FPVIOLflag;   /* CCIFflag, ACCERRflag, FPVIOLflag local variables*/
-
-  for(;;)
-  {
-    /* check if CCIF is 1,use mask to make it equal to x first and others 0*/
-    CCIFflag = FTFE_FSTAT & FTFE_FSTAT_CCIF_MASK;
-    /*when x=1,which means CCIF is 1*/
-    if(CCIFflag == FTFE_FSTAT_CCIF_MASK)
-    {
-      /*check if ACCERR and FPVIOL are both equal to 1,use mask to make them equal to x first and others 0*/
-      ACCERRflag = FTFE_FSTAT &FTFE_FSTAT_ACCERR_MASK;
-      FPVIOLflag = FTFE_FSTAT &FTFE_FSTAT_FPVIOL_MASK;
-      /*when x=1,which means they are 1 */
-      if(ACCERRflag == FTFE_FSTAT_ACCERR_MASK && FPVIOLflag == FTFE_FSTAT_FPVIOL_MASK)
-      {
-	/*clear the old errors and write 0x30 to FSTAT register*/
-	FTFE_FSTAT = 0x30;
-      }
-      /*write to the FCCOB register to load the required command parameter
-      do erase data follow the pin name of FCCOB*/
-      FTFE_FCCOB0 = 0x09;
-      /*follow the first address0x080000*/
-      FTFE_FCCOB1 = 0x08;
-      FTFE_FCCOB2 = 0x00;
-      FTFE_FCCOB3 = 0x00;
-      /*clear the CCIF to launch the command write 0x80 to FSTAT register*/
-      FTFE_FSTAT = 0x80;
-      return bTRUE;
-    }
-  }
-  //return bFALSE;
-}
-/* END Flash */
-/*!
-** @}
-*/
-
-
+/*! @file
+ *
+ *  @brief Flash module: Routines for erasing and writing to the Flash.
+ *
+ *  This module contains the functions needed for accessing the internal Flash.
+ *
+ *  @author Liang Wang
+ *  @date 2016-06-10
+ */
+/*!
+**  @addtogroup Flash_module Flash module documentation
+**  @{
+*/
+/* MODULE Flash */
+#include "Flash.h"
+#include "CRC.h"
+
+#define FIRST_ADDRESS                0x00080000            /*!<  a FIRST_ADDRESS and give it value */
+#define LAST_ADDRESS                 0x00080008            /*!<  a LAST_ADDRESS and give it value */
+#define LAST_AVALIABLE_SIZE2_ADDRESS 0x80006               /*!<  a LAST_AVALIABLE_SIZE2_ADDRESS and give it value */
+#define LAST_AVALIABLE_SIZE4_ADDRESS 0x80004               /*!<  LAST_AVALIABLE_SIZE4_ADDRESS and give it value */
+#define LOG_SECTOR_SIZE              0x1000                /*!<  the Flash erases 4 KB sectors */
+#define LOG_SECTOR(sector)           (FLASH_DATA_START + (sector) * LOG_SECTOR_SIZE)   /*!<  address of log sector 0 or 1 */
+#define LOG_NB_PHRASES               (LOG_SECTOR_SIZE / FLASH_PHRASE_SIZE)             /*!<  phrases in a sector, the first is the header */
+#define LOG_RECORD_MAX_DATA          (FLASH_PHRASE_SIZE - 3)                           /*!<  bytes in a record, besides offset, count and CRC */
+#define LOG_MAGIC0                   'L'                   /*!<  the header starts "LOG" */
+#define LOG_MAGIC1                   'O'
+#define LOG_MAGIC2                   'G'
+static int ptrAdd= FIRST_ADDRESS;                          /*!<  a local variable */
+static uint8_t Shadow[FLASH_DATA_SIZE];                    /*!<  the newest value of the data storage, replayed from the log at boot */
+static uint8_t ActiveSector;                               /*!<  the log sector records are appended to */
+static uint32_t Generation;                                /*!<  the generation in its header, a compaction adds 1 */
+static uint16_t NextPhrase;                                /*!<  the first free phrase of the active sector */
+static BOOL Reopened;                                      /*!<  the end of the log may be partly programmed: it was replayed at boot or an append failed, and has not been compacted since */
+
+BOOL Flash_AllocateVar(volatile void **variable, const uint8_t size)
+{
+  /* align flash address. */
+  if(ptrAdd>LAST_ADDRESS)
+    ptrAdd = FIRST_ADDRESS;
+  if(size == 2)
+  {
+    if(ptrAdd>LAST_AVALIABLE_SIZE2_ADDRESS)
+      ptrAdd = FIRST_ADDRESS;
+    ptrAdd +=(ptrAdd%2);
+  }
+  if(size == 4 && ptrAdd%4!=0)
+  {
+    if(ptrAdd >LAST_AVALIABLE_SIZE4_ADDRESS)
+      ptrAdd = FIRST_ADDRESS;
+    ptrAdd =ptrAdd+ 4 - (ptrAdd%4);
+  }
+  /*give the data on ptrAdd to the position of the pointer point to */
+  *variable= (int *)ptrAdd;
+  /*allocate address to the next data, if size is 2, and the first address is 0x80000,the the next address is 0x80002*/
+  ptrAdd +=size;
+  return bTRUE;
+}
+
+
+/*! @brief wait until the flash is ready for a command and clear the errors the last one left.
+ *
+ *  @return void
+ */
+static void Flash_WaitReady(void)
+{
+  /*wait for CCIF to be 1, no command is running*/
+  while(!(FTFE_FSTAT & FTFE_FSTAT_CCIF_MASK))
+    ;
+  /*a command cannot be launched while ACCERR or FPVIOL is set, clear either of them by writing 1 to it*/
+  if(FTFE_FSTAT & (FTFE_FSTAT_ACCERR_MASK | FTFE_FSTAT_FPVIOL_MASK))
+    FTFE_FSTAT = FTFE_FSTAT_ACCERR_MASK | FTFE_FSTAT_FPVIOL_MASK;
+}
+
+/*! @brief launch the command loaded into the FCCOB registers and wait for it to complete.
+ *
+ *  @return BOOL - TRUE if the command completed without an access error, a protection violation or a failed verify.
+ */
+static BOOL Flash_Launch(void)
+{
+  /*clear the CCIF to launch the command write 0x80 to FSTAT register*/
+  FTFE_FSTAT = FTFE_FSTAT_CCIF_MASK;
+  /*CCIF is 1 again once the command has completed*/
+  while(!(FTFE_FSTAT & FTFE_FSTAT_CCIF_MASK))
+    ;
+  return !(FTFE_FSTAT & (FTFE_FSTAT_ACCERR_MASK | FTFE_FSTAT_FPVIOL_MASK | FTFE_FSTAT_MGSTAT0_MASK));
+}
+
+/*! @brief program a phrase of flash, which has to be erased.
+ *
+ *  @param address The address of the phrase, a multiple of FLASH_PHRASE_SIZE.
+ *  @param phrase The FLASH_PHRASE_SIZE bytes to program.
+ *  @return BOOL - TRUE if the phrase was programmed.
+ */
+static BOOL Flash_ProgramPhrase(const uint32_t address, const uint8_t phrase[])
+{
+  Flash_WaitReady();
+  /*write to the FCCOB register to load the required command parameter
+  do write data follow the pin name of FCCOB*/
+  FTFE_FCCOB0 = 0x07;
+  /*the address of the phrase, most significant byte first*/
+  FTFE_FCCOB1 = (address >> 16) & 0xFF;
+  FTFE_FCCOB2 = (address >> 8) & 0xFF;
+  FTFE_FCCOB3 = address & 0xFF;
+  /*copy the data changed in ram buffer back into flash, follow THE typedef structure FTFE_MemMap inMK70F12,h*/
+  FTFE_FCCOB7 = phrase[0];
+  FTFE_FCCOB6 = phrase[1];
+  FTFE_FCCOB5 = phrase[2];
+  FTFE_FCCOB4 = phrase[3];
+  FTFE_FCCOBB = phrase[4];
+  FTFE_FCCOBA = phrase[5];
+  FTFE_FCCOB9 = phrase[6];
+  FTFE_FCCOB8 = phrase[7];
+  return Flash_Launch();
+}
+
+/*! @brief erase a sector of flash.
+ *
+ *  @param address The address of the sector, a multiple of LOG_SECTOR_SIZE.
+ *  @return BOOL - TRUE if the sector was erased.
+ */
+static BOOL Flash_EraseSector(const uint32_t address)
+{
+  Flash_WaitReady();
+  /*write to the FCCOB register to load the required command parameter
+  do erase data follow the pin name of FCCOB*/
+  FTFE_FCCOB0 = 0x09;
+  /*the address of the sector, most significant byte first*/
+  FTFE_FCCOB1 = (address >> 16) & 0xFF;
+  FTFE_FCCOB2 = (address >> 8) & 0xFF;
+  FTFE_FCCOB3 = address & 0xFF;
+  return Flash_Launch();
+}
+
+/*! @brief copy a phrase of the log out of flash.
+ *
+ *  @param sector The log sector, 0 or 1.
+ *  @param index The index of the phrase in the sector.
+ *  @param phrase Where the FLASH_PHRASE_SIZE bytes are put.
+ *  @return BOOL - TRUE if the phrase is erased (all 0xFF).
+ */
+static BOOL Flash_ReadPhrase(const uint8_t sector, const uint16_t index, uint8_t phrase[])
+{
+  BOOL erased = bTRUE;
+  uint16_t i;
+
+  for(i = 0; i < FLASH_PHRASE_SIZE; i++)
+  {
+    phrase[i] = _FB(LOG_SECTOR(sector) + index * FLASH_PHRASE_SIZE + i);
+    erased &= (phrase[i] == 0xFF);
+  }
+  return erased;
+}
+
+/*! @brief read the header of a log sector.
+ *
+ *  @param sector The log sector, 0 or 1.
+ *  @param generation Where the generation of the sector is put.
+ *  @return BOOL - TRUE if the sector has a valid header, which is only programmed once the sector is complete.
+ */
+static BOOL Flash_ReadHeader(const uint8_t sector, uint32_t* const generation)
+{
+  uint8_t header[FLASH_PHRASE_SIZE];
+
+  (void)Flash_ReadPhrase(sector, 0, header);
+  if(header[0] != LOG_MAGIC0 || header[1] != LOG_MAGIC1 || header[2] != LOG_MAGIC2
+     || header[FLASH_PHRASE_SIZE - 1] != CRC_8(header, FLASH_PHRASE_SIZE - 1))
+    return bFALSE;
+  *generation = header[3] | ((uint32_t)header[4] << 8) | ((uint32_t)header[5] << 16) | ((uint32_t)header[6] << 24);
+  return bTRUE;
+}
+
+/*! @brief replay the records of the active sector into the shadow, oldest first, so the newest values win.
+ *
+ *  the records are appended in order, so the first erased phrase is the end of the log. A record cut short
+ *  by a reset fails its check and is skipped, but its phrase is not reused. One cut short before any of its
+ *  bits took can still read as erased, so it is not appended to either: see Flash_Update.
+ *  @return void
+ */
+static void Flash_Replay(void)
+{
+  uint8_t record[FLASH_PHRASE_SIZE];
+  uint16_t i;
+
+  for(NextPhrase = 1; NextPhrase < LOG_NB_PHRASES; NextPhrase++)
+  {
+    if(Flash_ReadPhrase(ActiveSector, NextPhrase, record))
+      break;
+    if(record[FLASH_PHRASE_SIZE - 1] != CRC_8(record, FLASH_PHRASE_SIZE - 1)
+       || record[1] == 0 || record[1] > LOG_RECORD_MAX_DATA || record[0] + record[1] > FLASH_DATA_SIZE)
+      continue;
+    for(i = 0; i < record[1]; i++)
+      Shadow[record[0] + i] = record[2 + i];
+  }
+}
+
+/*! @brief append records for bytes of the data storage to a log sector, LOG_RECORD_MAX_DATA bytes to a record.
+ *
+ *  a record is one phrase: the offset of its first byte, the number of bytes, the bytes padded with 0xFF, and a
+ *  CRC-8 of the rest. It is only ever programmed into an erased phrase.
+ *  @param sector The log sector, 0 or 1.
+ *  @param index The index of the first free phrase in the sector, moved past the records.
+ *  @param offset The offset of the first byte from FLASH_DATA_START.
+ *  @param data The bytes.
+ *  @param nbBytes The number of bytes.
+ *  @return BOOL - TRUE if the records were programmed.
+ */
+static BOOL Flash_Append(const uint8_t sector, uint16_t* const index, uint16_t offset, const uint8_t data[], uint16_t nbBytes)
+{
+  uint8_t record[FLASH_PHRASE_SIZE];
+  uint16_t i, n;
+
+  while(nbBytes > 0)
+  {
+    n = (nbBytes < LOG_RECORD_MAX_DATA) ? nbBytes : LOG_RECORD_MAX_DATA;
+    record[0] = offset;
+    record[1] = n;
+    for(i = 0; i < LOG_RECORD_MAX_DATA; i++)
+      record[2 + i] = (i < n) ? data[i] : 0xFF;
+    record[FLASH_PHRASE_SIZE - 1] = CRC_8(record, FLASH_PHRASE_SIZE - 1);
+    if(!Flash_ProgramPhrase(LOG_SECTOR(sector) + *index * FLASH_PHRASE_SIZE, record))
+      return bFALSE;
+    (*index)++;
+    offset += n;
+    data += n;
+    nbBytes -= n;
+  }
+  return bTRUE;
+}
+
+/*! @brief start a new log in the other sector, holding only the given value of the data storage.
+ *
+ *  the other sector is erased, the bytes that are not 0xFF are appended as records and the header with the next
+ *  generation is programmed last. Until then the active sector stays the newest valid one, so a reset part way
+ *  through loses nothing. This is the only erase the log does, once every LOG_NB_PHRASES - 1 records, and on
+ *  the first write after a boot.
+ *  @param ram The value of the whole data storage, FLASH_DATA_SIZE bytes.
+ *  @return BOOL - TRUE if the new sector was written and is now the active one.
+ */
+static BOOL Flash_Compact(const uint8_t ram[])
+{
+  uint8_t other = 1 - ActiveSector;
+  uint8_t header[FLASH_PHRASE_SIZE];
+  uint16_t index = 1;     /*!< the first free phrase of the new sector*/
+  uint16_t offset, i, n;
+
+  if(!Flash_EraseSector(LOG_SECTOR(other)))
+    return bFALSE;
+  for(offset = 0; offset < FLASH_DATA_SIZE; offset += n)
+  {
+    n = (FLASH_DATA_SIZE - offset < LOG_RECORD_MAX_DATA) ? FLASH_DATA_SIZE - offset : LOG_RECORD_MAX_DATA;
+    /*!an erased byte needs no record*/
+    for(i = offset; i < offset + n && ram[i] == 0xFF; i++)
+      ;
+    if(i < offset + n && !Flash_Append(other, &index, offset, &ram[offset], n))
+      return bFALSE;
+  }
+  header[0] = LOG_MAGIC0;
+  header[1] = LOG_MAGIC1;
+  header[2] = LOG_MAGIC2;
+  header[3] = (Generation + 1) & 0xFF;
+  header[4] = ((Generation + 1) >> 8) & 0xFF;
+  header[5] = ((Generation + 1) >> 16) & 0xFF;
+  header[6] = (Generation + 1) >> 24;
+  header[FLASH_PHRASE_SIZE - 1] = CRC_8(header, FLASH_PHRASE_SIZE - 1);
+  if(!Flash_ProgramPhrase(LOG_SECTOR(other), header))
+    return bFALSE;
+  ActiveSector = other;
+  Generation++;
+  NextPhrase = index;
+  Reopened = bFALSE;
+  return bTRUE;
+}
+
+/*! @brief write bytes of the data storage, unless they already hold them.
+ *
+ *  the bytes from the first one that changes to the last one are appended to the log, which costs a phrase
+ *  program for every LOG_RECORD_MAX_DATA bytes. When the active sector has no room left for them, the new value
+ *  is compacted into the other sector instead. So is the first write after a boot: the log was found to end at
+ *  a phrase that reads erased, but a program cut short by the reset may have left it only partly programmed,
+ *  and programming it again could read back wrong.
+ *  @param offset The offset of the first byte from FLASH_DATA_START.
+ *  @param data The bytes to write.
+ *  @param nbBytes The number of bytes to write.
+ *  @return BOOL - TRUE if the bytes are in flash, FALSE if they go past FLASH_DATA_END or there is a programming error.
+ */
+static BOOL Flash_Update(const uint32_t offset, const uint8_t* const data, const uint16_t nbBytes)
+{
+  uint8_t ram[FLASH_DATA_SIZE];   /*!< the new value of the data storage*/
+  uint16_t first = FLASH_DATA_SIZE, last = 0;    /*!< the first and last bytes that change*/
+  uint16_t i;
+
+  /*!the offset is worked out from a 32-bit address, so it is checked whole: cut to 16 bits, an address far
+     outside the data storage could land inside it*/
+  if(offset > FLASH_DATA_SIZE || nbBytes > FLASH_DATA_SIZE - offset)
+    return bFALSE;
+  for(i = 0; i < FLASH_DATA_SIZE; i++)
+    ram[i] = Shadow[i];
+  for(i = offset; i < offset + nbBytes; i++)
+  {
+    if(ram[i] != data[i - offset])
+    {
+      if(first == FLASH_DATA_SIZE)
+        first = i;
+      last = i;
+    }
+    ram[i] = data[i - offset];
+  }
+  /*!writing the value already there costs no erase and no program*/
+  if(first == FLASH_DATA_SIZE)
+    return bTRUE;
+  if(!Reopened && NextPhrase + (last - first + LOG_RECORD_MAX_DATA) / LOG_RECORD_MAX_DATA <= LOG_NB_PHRASES)
+  {
+    if(!Flash_Append(ActiveSector, &NextPhrase, first, &ram[first], last - first + 1))
+    {
+      /*!the phrase that failed may be partly programmed, so it is not appended to again: the next write
+         compacts, which also leaves out the records of this one that did get programmed*/
+      Reopened = bTRUE;
+      return bFALSE;
+    }
+  }
+  else if(!Flash_Compact(ram))
+    return bFALSE;
+  for(i = 0; i < FLASH_DATA_SIZE; i++)
+    Shadow[i] = ram[i];
+  return bTRUE;
+}
+
+BOOL Flash_Init(void)
+{
+  uint32_t generation0, generation1;
+  BOOL valid0, valid1;
+  uint16_t i;
+
+  /*enable the flash memory gate*/
+  SIM_SCGC3 |= SIM_SCGC3_NFC_MASK;
+  for(i = 0; i < FLASH_DATA_SIZE; i++)
+    Shadow[i] = 0xFF;
+  valid0 = Flash_ReadHeader(0, &generation0);
+  valid1 = Flash_ReadHeader(1, &generation1);
+  if(!valid0 && !valid1)
+  {
+    /*!no log yet: the data storage is still the phrase at FLASH_DATA_START, carry it over into a log in sector 1*/
+    for(i = 0; i < FLASH_DATA_SIZE; i++)
+      Shadow[i] = _FB(FLASH_DATA_START + i);
+    ActiveSector = 0;
+    Generation = 0;
+    return Flash_Compact(Shadow);
+  }
+  /*!the newer sector is the log, the older one is left over from the last compaction*/
+  ActiveSector = (valid1 && (!valid0 || generation1 > generation0)) ? 1 : 0;
+  Generation = ActiveSector ? generation1 : generation0;
+  Flash_Replay();
+  Reopened = bTRUE;
+  return bTRUE;
+}
+
+
+BOOL Flash_Write32(uint32_t volatile * const address, const uint32_t data)
+{
+  uint8_t bytes[4];    /*the 32 bits data, least significant byte first as the processor reads it*/
+
+  if((uint32_t)address % 4 != 0)
+    return bFALSE;
+  bytes[0] = data & 0xFF;
+  bytes[1] = (data >> 8) & 0xFF;
+  bytes[2] = (data >> 16) & 0xFF;
+  bytes[3] = data >> 24;
+  return Flash_Update((uint32_t)address - FLASH_DATA_START, bytes, sizeof(bytes));
+}
+
+
+BOOL Flash_Write16(uint16_t volatile * const address, const uint16_t data)
+{
+  uint16union_t data16;     /* a 16 bits data*/
+  uint8_t bytes[2];
+
+  if((uint32_t)address % 2 != 0)
+    return bFALSE;
+  data16.l = data;          /*Separate 16 bits to two 8 bit number*/
+  bytes[0] = data16.s.Lo;
+  bytes[1] = data16.s.Hi;
+  return Flash_Update((uint32_t)address - FLASH_DATA_START, bytes, sizeof(bytes));
+}
+
+
+BOOL Flash_Write8(uint8_t volatile * const address, const uint8_t data)
+{
+  return Flash_Update((uint32_t)address - FLASH_DATA_START, &data, 1);
+}
+
+
+uint32_t Flash_Read32(uint32_t volatile * const address)
+{
+  uint32_t offset = (uint32_t)address - FLASH_DATA_START;
+
+  if(offset > FLASH_DATA_SIZE - 4)
+    return *address;
+  return Shadow[offset] | ((uint32_t)Shadow[offset + 1] << 8) | ((uint32_t)Shadow[offset + 2] << 16) | ((uint32_t)Shadow[offset + 3] << 24);
+}
+
+
+uint16_t Flash_Read16(uint16_t volatile * const address)
+{
+  uint32_t offset = (uint32_t)address - FLASH_DATA_START;
+
+  if(offset > FLASH_DATA_SIZE - 2)
+    return *address;
+  return Shadow[offset] | (Shadow[offset + 1] << 8);
+}
+
+
+uint8_t Flash_Read8(uint8_t volatile * const address)
+{
+  uint32_t offset = (uint32_t)address - FLASH_DATA_START;
+
+  if(offset > FLASH_DATA_SIZE - 1)
+    return *address;
+  return Shadow[offset];
+}
+
+
+BOOL Flash_WriteBlock(const uint16_t offset, const uint8_t* const data, const uint16_t nbBytes)
+{
+  return Flash_Update(offset, data, nbBytes);
+}
+
+
+BOOL Flash_ReadBlock(const uint16_t offset, uint8_t* const data, const uint16_t nbBytes)
+{
+  uint16_t i;
+
+  if(offset > FLASH_DATA_SIZE || nbBytes > FLASH_DATA_SIZE - offset)
+    return bFALSE;
+  for(i = 0; i < nbBytes; i++)
+    data[i] = Shadow[offset + i];
+  return bTRUE;
+}
+
+
+BOOL Flash_Erase(void)
+{
+  uint8_t erased[FLASH_DATA_SIZE];   /* an erased byte reads 0xFF*/
+  uint16_t i;
+
+  for(i = 0; i < FLASH_DATA_SIZE; i++)
+    erased[i] = 0xFF;
+  return Flash_Update(0, erased, FLASH_DATA_SIZE);
+}
+/* END Flash */
+/*!
+** @}
+*/
+
+
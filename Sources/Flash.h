@@ -1,85 +1,137 @@
-/*! @file
- *
- *  @brief Routines for erasing and writing to the Flash.
- *
- *  This contains the functions needed for accessing the internal Flash.
- *
- *  @author PMcL
- *  @date 2015-08-07
- */
-
-#ifndef FLASH_H
-#define FLASH_H
-
-// new types
-#include "types.h"
-#include "PE_Types.h"
-#include "Cpu.h"
-#include "MK70F12.h"
-// FLASH data access
-#define _FB(flashAddress)  *(uint8_t  volatile *)(flashAddress)
-#define _FH(flashAddress)  *(uint16_t volatile *)(flashAddress)
-#define _FW(flashAddress)  *(uint32_t volatile *)(flashAddress)
-#define _FP(flashAddress)  *(uint64_t volatile *)(flashAddress)
-
-// Address of the start of the Flash block we are using for data storage
-#define FLASH_DATA_START 0x00080000LU
-// Address of the end of the Flash block we are using for data storage
-#define FLASH_DATA_END   0x00080007LU
-
-/*! @brief Enables the Flash module.
- *
- *  @return BOOL - TRUE if the Flash was setup successfully.
- */
-BOOL Flash_Init(void);
- 
-/*! @brief Allocates space for a non-volatile variable in the Flash memory.
- *
- *  @param variable is the address of a pointer to a variable that is to be allocated space in Flash memory.
- *         The pointer will be allocated to a relevant address:
- *         If the variable is a byte, then any address.
- *         If the variable is a half-word, then an even address.
- *         If the variable is a word, then an address divisible by 4.
- *         This allows the resulting variable to be used with the relevant Flash_Write function which assumes a certain memory address.
- *         e.g. a 16-bit variable will be on an even address
- *  @param size The size, in bytes, of the variable that is to be allocated space in the Flash memory. Valid values are 1, 2 and 4.
- *  @return BOOL - TRUE if the variable was allocated space in the Flash memory.
- *  @note Assumes Flash has been initialized.
- */
-BOOL Flash_AllocateVar(volatile void** variable, const uint8_t size);
-
-/*! @brief Writes a 32-bit number to Flash.
- *
- *  @param address The address of the data.
- *  @param data The 32-bit data to write.
- *  @return BOOL - TRUE if Flash was written successfully, FALSE if address is not aligned to a 4-byte boundary or if there is a programming error.
- *  @note Assumes Flash has been initialized.
- */
-BOOL Flash_Write32(volatile uint32_t* const address, const uint32_t data);
- 
-/*! @brief Writes a 16-bit number to Flash.
- *
- *  @param address The address of the data.
- *  @param data The 16-bit data to write.
- *  @return BOOL - TRUE if Flash was written successfully, FALSE if address is not aligned to a 2-byte boundary or if there is a programming error.
- *  @note Assumes Flash has been initialized.
- */
-BOOL Flash_Write16(volatile uint16_t* const address, const uint16_t data);
-
-/*! @brief Writes an 8-bit number to Flash.
- *
- *  @param address The address of the data.
- *  @param data The 8-bit data to write.
- *  @return BOOL - TRUE if Flash was written successfully, FALSE if there is a programming error.
- *  @note Assumes Flash has been initialized.
- */
-BOOL Flash_Write8(volatile uint8_t* const address, const uint8_t data);
-
-/*! @brief Erases the entire Flash sector.
- *
- *  @return BOOL - TRUE if the Flash "data" sector was erased successfully.
- *  @note Assumes Flash has been initialized.
- */
-BOOL Flash_Erase(void);
-
-#endif
+/*! @file
+ *
+ *  @brief Routines for erasing and writing to the Flash.
+ *
+ *  This contains the functions needed for accessing the internal Flash.
+ *  The data storage is kept as a log of records in two 4 KB sectors from FLASH_DATA_START. A write appends
+ *  a record of the bytes that change to the next free phrase, which costs one phrase program and no erase.
+ *  When a sector is full the newest values are compacted into the other one, the only time a sector is erased.
+ *  Flash_Init replays the log into RAM, so reads do not go to the Flash.
+ *
+ *  @author PMcL
+ *  @date 2015-08-07
+ */
+
+#ifndef FLASH_H
+#define FLASH_H
+
+// new types
+#include "types.h"
+#include "PE_Types.h"
+#include "Cpu.h"
+#include "MK70F12.h"
+// FLASH data access
+#define _FB(flashAddress)  *(uint8_t  volatile *)(flashAddress)
+#define _FH(flashAddress)  *(uint16_t volatile *)(flashAddress)
+#define _FW(flashAddress)  *(uint32_t volatile *)(flashAddress)
+#define _FP(flashAddress)  *(uint64_t volatile *)(flashAddress)
+
+// Address of the start of the data storage, variables are allocated from it; its log takes the two sectors from here
+#define FLASH_DATA_START 0x00080000LU
+// Address of the end of the data storage
+#define FLASH_DATA_END   0x00080007LU
+// Number of bytes of data storage, a whole number of phrases
+#define FLASH_DATA_SIZE  (FLASH_DATA_END - FLASH_DATA_START + 1)
+// Number of bytes the Flash programs at a time
+#define FLASH_PHRASE_SIZE 8
+
+/*! @brief Enables the Flash module.
+ *
+ *  @return BOOL - TRUE if the Flash was setup successfully.
+ */
+BOOL Flash_Init(void);
+ 
+/*! @brief Allocates space for a non-volatile variable in the Flash memory.
+ *
+ *  @param variable is the address of a pointer to a variable that is to be allocated space in Flash memory.
+ *         The pointer will be allocated to a relevant address:
+ *         If the variable is a byte, then any address.
+ *         If the variable is a half-word, then an even address.
+ *         If the variable is a word, then an address divisible by 4.
+ *         This allows the resulting variable to be used with the relevant Flash_Write function which assumes a certain memory address.
+ *         e.g. a 16-bit variable will be on an even address
+ *  @param size The size, in bytes, of the variable that is to be allocated space in the Flash memory. Valid values are 1, 2 and 4.
+ *  @return BOOL - TRUE if the variable was allocated space in the Flash memory.
+ *  @note Assumes Flash has been initialized.
+ */
+BOOL Flash_AllocateVar(volatile void** variable, const uint8_t size);
+
+/*! @brief Writes a 32-bit number to Flash.
+ *
+ *  @param address The address of the data.
+ *  @param data The 32-bit data to write.
+ *  @return BOOL - TRUE if Flash was written successfully, FALSE if address is not aligned to a 4-byte boundary or if there is a programming error.
+ *  @note The data is stored least significant byte first, as Flash_Read32 and the processor read it.
+ *  @note Assumes Flash has been initialized.
+ */
+BOOL Flash_Write32(volatile uint32_t* const address, const uint32_t data);
+ 
+/*! @brief Writes a 16-bit number to Flash.
+ *
+ *  @param address The address of the data.
+ *  @param data The 16-bit data to write.
+ *  @return BOOL - TRUE if Flash was written successfully, FALSE if address is not aligned to a 2-byte boundary or if there is a programming error.
+ *  @note Assumes Flash has been initialized.
+ */
+BOOL Flash_Write16(volatile uint16_t* const address, const uint16_t data);
+
+/*! @brief Writes an 8-bit number to Flash.
+ *
+ *  @param address The address of the data.
+ *  @param data The 8-bit data to write.
+ *  @return BOOL - TRUE if Flash was written successfully, FALSE if there is a programming error.
+ *  @note Assumes Flash has been initialized.
+ */
+BOOL Flash_Write8(volatile uint8_t* const address, const uint8_t data);
+
+/*! @brief Writes a block of bytes to the Flash data storage in as few records as it can.
+ *
+ *  The rest of the data storage keeps its value. Writing a whole phrase this way costs two phrase programs,
+ *  where writing it with Flash_Write8 costs one for each byte.
+ *  @param offset The offset of the first byte from FLASH_DATA_START.
+ *  @param data The bytes to write.
+ *  @param nbBytes The number of bytes to write.
+ *  @return BOOL - TRUE if Flash was written successfully, FALSE if the block goes past FLASH_DATA_END.
+ *  @note Assumes Flash has been initialized.
+ */
+BOOL Flash_WriteBlock(const uint16_t offset, const uint8_t* const data, const uint16_t nbBytes);
+
+/*! @brief Reads a block of bytes from the Flash data storage.
+ *
+ *  @param offset The offset of the first byte from FLASH_DATA_START.
+ *  @param data Where the bytes are put.
+ *  @param nbBytes The number of bytes to read.
+ *  @return BOOL - TRUE if the bytes were read, FALSE if the block goes past FLASH_DATA_END.
+ */
+BOOL Flash_ReadBlock(const uint16_t offset, uint8_t* const data, const uint16_t nbBytes);
+
+/*! @brief Reads a 32-bit number from Flash.
+ *
+ *  @param address The address of the data.
+ *  @return uint32_t - The data, from the copy in RAM if it is in the data storage.
+ */
+uint32_t Flash_Read32(volatile uint32_t* const address);
+
+/*! @brief Reads a 16-bit number from Flash.
+ *
+ *  @param address The address of the data.
+ *  @return uint16_t - The data, from the copy in RAM if it is in the data storage.
+ */
+uint16_t Flash_Read16(volatile uint16_t* const address);
+
+/*! @brief Reads an 8-bit number from Flash.
+ *
+ *  @param address The address of the data.
+ *  @return uint8_t - The data, from the copy in RAM if it is in the data storage.
+ */
+uint8_t Flash_Read8(volatile uint8_t* const address);
+
+/*! @brief Erases the data storage, every byte of it reads 0xFF again.
+ *
+ *  This is written to the log like any other write, it does not erase a sector.
+ *  @return BOOL - TRUE if the data storage was erased successfully.
+ *  @note Assumes Flash has been initialized.
+ */
+BOOL Flash_Erase(void);
+
+#endif
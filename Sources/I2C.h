@@ -1,94 +1,94 @@
-/*! @file
- *
- *  @brief I/O routines for the K70 I2C interface.
- *
- *  This contains the functions for operating the I2C (inter-integrated circuit) module.
- *
- *  @author PMcL
- *  @date 2015-09-17
- */
-
-#ifndef I2C_H
-#define I2C_H
-
-// new types
-#include "types.h"
-#include "MK70F12.h"
-#include "Cpu.h"
-uint8_t data[3];
-typedef struct
-{
-  uint8_t primarySlaveAddress;
-  uint32_t baudRate;
-  void (*readCompleteCallbackFunction)(void*);  /*!< The user's read complete callback function. */
-  void* readCompleteCallbackArguments;          /*!< The user's read complete callback function arguments. */
-} TI2CModule;
-#define WRITE 0x00
-#define READ 0x01
-#define start() 	I2C0_C1 |= I2C_C1_TX_MASK;	\
-			I2C0_C1 |= I2C_C1_MST_MASK
-
-#define stop() 		I2C0_C1 &= ~I2C_C1_TX_MASK;	\
-			I2C0_C1 &= ~I2C_C1_MST_MASK
-
-//#define wait() 							\
-		while(!(I2C0_S & I2C_S_IICIF_MASK)) 	\
-		{}                                      \
-                I2C0_S |= I2C_S_IICIF_MASK
-
-/*! @brief return absolute value of input.
- *
- *  @param x is integer to be input.
- *  @return absolute value of input.
- */
-int ABS(int x);
-
-/*! @brief Sets up the I2C before first use.
- *
- *  @param aI2CModule is a structure containing the operating conditions for the module.
- *  @param moduleClk The module clock in Hz.
- *  @return BOOL - TRUE if the I2C module was successfully initialized.
- */
-BOOL I2C_Init(const TI2CModule* const aI2CModule, const uint32_t moduleClk);
-
-/*! @brief Selects the current slave device
- *
- * @param slaveAddress The slave device address.
- */
-void I2C_SelectSlaveDevice(const uint8_t slaveAddress);
-
-/*! @brief Write a byte of data to a specified register
- *
- * @param registerAddress The register address.
- * @param data The 8-bit data to write.
- */
-void I2C_Write(const uint8_t registerAddress, const uint8_t data);
-
-/*! @brief Reads data of a specified length starting from a specified register
- *
- * Uses polling as the method of data reception.
- * @param registerAddress The register address.
- * @param data A pointer to store the bytes that are read.
- * @param nbBytes The number of bytes to read.
- */
-void I2C_PollRead(const uint8_t registerAddress, uint8_t* const data, const uint8_t nbBytes);
-
-/*! @brief Reads data of a specified length starting from a specified register
- *
- * Uses interrupts as the method of data reception.
- * @param registerAddress The register address.
- * @param data A pointer to store the bytes that are read.
- * @param nbBytes The number of bytes to read.
- */
-void I2C_IntRead(const uint8_t registerAddress, uint8_t* const data, const uint8_t nbBytes);
-
-/*! @brief Interrupt service routine for the I2C.
- *
- *  Only used for reading data.
- *  At the end of reception, the user callback function will be called.
- *  @note Assumes the I2C module has been initialized.
- */
-void __attribute__ ((interrupt)) I2C_ISR(void);
-
-
-#endif
+/*! @file
+ *
+ *  @brief I/O routines for the K70 I2C interface.
+ *
+ *  This contains the functions for operating the I2C (inter-integrated circuit) module.
+ *
+ *  @author PMcL
+ *  @date 2015-09-17
+ */
+
+#ifndef I2C_H
+#define I2C_H
+
+// new types
+#include "types.h"
+#include "MK70F12.h"
+#include "Cpu.h"
+uint8_t data[3];
+typedef struct
+{
+  uint8_t primarySlaveAddress;
+  uint32_t baudRate;
+  void (*readCompleteCallbackFunction)(void*);  /*!< The user's read complete callback function. */
+  void* readCompleteCallbackArguments;          /*!< The user's read complete callback function arguments. */
+} TI2CModule;
+#define WRITE 0x00
+#define READ 0x01
+#define start() 	I2C0_C1 |= I2C_C1_TX_MASK;	\
+			I2C0_C1 |= I2C_C1_MST_MASK
+
+#define stop() 		I2C0_C1 &= ~I2C_C1_TX_MASK;	\
+			I2C0_C1 &= ~I2C_C1_MST_MASK
+
+//#define wait() 							\
+		while(!(I2C0_S & I2C_S_IICIF_MASK)) 	\
+		{}                                      \
+                I2C0_S |= I2C_S_IICIF_MASK
+
+/*! @brief return absolute value of input.
+ *
+ *  @param x is integer to be input.
+ *  @return absolute value of input.
+ */
+int ABS(int x);
+
+/*! @brief Sets up the I2C before first use.
+ *
+ *  @param aI2CModule is a structure containing the operating conditions for the module.
+ *  @param moduleClk The module clock in Hz.
+ *  @return BOOL - TRUE if the I2C module was successfully initialized.
+ */
+BOOL I2C_Init(const TI2CModule* const aI2CModule, const uint32_t moduleClk);
+
+/*! @brief Selects the current slave device
+ *
+ * @param slaveAddress The slave device address.
+ */
+void I2C_SelectSlaveDevice(const uint8_t slaveAddress);
+
+/*! @brief Write a byte of data to a specified register
+ *
+ * @param registerAddress The register address.
+ * @param data The 8-bit data to write.
+ */
+void I2C_Write(const uint8_t registerAddress, const uint8_t data);
+
+/*! @brief Reads data of a specified length starting from a specified register
+ *
+ * Uses polling as the method of data reception.
+ * @param registerAddress The register address.
+ * @param data A pointer to store the bytes that are read.
+ * @param nbBytes The number of bytes to read.
+ */
+void I2C_PollRead(const uint8_t registerAddress, uint8_t* const data, const uint8_t nbBytes);
+
+/*! @brief Reads data of a specified length starting from a specified register
+ *
+ * Uses interrupts as the method of data reception.
+ * @param registerAddress The register address.
+ * @param data A pointer to store the bytes that are read.
+ * @param nbBytes The number of bytes to read.
+ */
+void I2C_IntRead(const uint8_t registerAddress, uint8_t* const data, const uint8_t nbBytes);
+
+/*! @brief Interrupt service routine for the I2C.
+ *
+ *  Only used for reading data.
+ *  At the end of reception, the user callback function will be called.
+ *  @note Assumes the I2C module has been initialized.
+ */
+void __attribute__ ((interrupt)) I2C_ISR(void);
+
+
+#endif
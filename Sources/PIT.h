@@ -1,54 +1,64 @@
-/*! @file
- *
- *  @brief Routines for controlling Periodic Interrupt Timer (PIT) on the TWR-K70F120M.
- *
- *  This contains the functions for operating the periodic interrupt timer (PIT).
- *
- *  @author PMcL
- *  @date 2015-08-22
- */
-
-#ifndef PIT_H
-#define PIT_H
-
-// new types
-#include "types.h"
-#include "MK70F12.h"
-#include "LEDs.h"
-#include "Cpu.h"
-
-/*! @brief Sets up the PIT before first use.
- *
- *  Enables the PIT and freezes the timer when debugging.
- *  @param moduleClk The module clock rate in Hz.
- *  @param userFunction is a pointer to a user callback function.
- *  @param userArguments is a pointer to the user arguments to use with the user callback function.
- *  @return BOOL - TRUE if the PIT was successfully initialized.
- *  @note Assumes that moduleClk has a period which can be expressed as an integral number of nanoseconds.
- */
-BOOL PIT_Init(const uint32_t moduleClk, void (*userFunction)(void*), void* userArguments);
-
-/*! @brief Sets the value of the desired period of the PIT.
- *
- *  @param period The desired value of the timer period in nanoseconds.
- *  @param restart TRUE if the PIT is disabled, a new value set, and then enabled.
- *                 FALSE if the PIT will use the new value after a trigger event.
- *  @note The function will enable the timer and interrupts for the PIT.
- */
-void PIT_Set(const uint32_t period, const BOOL restart);
-
-/*! @brief Enables or disables the PIT.
- *
- *  @param enable - TRUE if the PIT is to be enabled, FALSE if the PIT is to be disabled.
- */
-void PIT_Enable(const BOOL enable);
-
-/*! @brief Interrupt service routine for the PIT.
- *
- *  The periodic interrupt timer has timed out.
- *  The user callback function will be called.
- *  @note Assumes the PIT has been initialized.
- */
-void __attribute__ ((interrupt)) PIT_ISR(void);
-
-#endif
+/*! @file
+ *
+ *  @brief Routines for controlling Periodic Interrupt Timer (PIT) on the TWR-K70F120M.
+ *
+ *  This contains the functions for operating the periodic interrupt timer (PIT).
+ *
+ *  @author PMcL
+ *  @date 2015-08-22
+ */
+
+#ifndef PIT_H
+#define PIT_H
+
+// new types
+#include "types.h"
+#include "MK70F12.h"
+#include "LEDs.h"
+#include "Cpu.h"
+
+/*! @brief Sets up the PIT before first use.
+ *
+ *  Enables the PIT and freezes the timer when debugging.
+ *  Also starts the microsecond count read with PIT_Microseconds, on channels 1 and 2.
+ *  @param moduleClk The module clock rate in Hz.
+ *  @param userFunction is a pointer to a user callback function.
+ *  @param userArguments is a pointer to the user arguments to use with the user callback function.
+ *  @return BOOL - TRUE if the PIT was successfully initialized.
+ *  @note Assumes that moduleClk has a period which can be expressed as an integral number of nanoseconds.
+ */
+BOOL PIT_Init(const uint32_t moduleClk, void (*userFunction)(void*), void* userArguments);
+
+/*! @brief Sets the value of the desired period of the PIT.
+ *
+ *  @param period The desired value of the timer period in nanoseconds.
+ *  @param restart TRUE if the PIT is disabled, a new value set, and then enabled.
+ *                 FALSE if the PIT will use the new value after a trigger event.
+ *  @note The function will enable the timer and interrupts for the PIT.
+ */
+void PIT_Set(const uint32_t period, const BOOL restart);
+
+/*! @brief Enables or disables the PIT.
+ *
+ *  @param enable - TRUE if the PIT is to be enabled, FALSE if the PIT is to be disabled.
+ */
+void PIT_Enable(const BOOL enable);
+
+/*! @brief Gets the number of microseconds since PIT_Init.
+ *
+ *  Channel 1 divides the module clock down to 1 MHz and channel 2, chained to it, counts the microseconds,
+ *  so reading the count needs no interrupts and no critical section.
+ *  @return uint32_t - The microsecond count, wraps around after about 71 minutes.
+ *  @note Assumes that PIT_Init has been called with a module clock that is a whole number of MHz.
+ */
+uint32_t PIT_Microseconds(void);
+
+/*! @brief Interrupt service routine for the PIT.
+ *
+ *  The periodic interrupt timer has timed out.
+ *  The user callback function will be called.
+ *  @note Assumes the PIT has been initialized.
+ */
+void __attribute__ ((interrupt)) PIT_ISR(void);
+
+#endif
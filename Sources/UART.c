@@ -1,110 +1,662 @@
-/*! @file
- *
- *  @brief UART module: I/O routines for UART communications on the TWR-K70F120M.
- *
- *  This module contains the functions for operating the UART (serial port).
- *
- *  @author Liang Wang
- *  @date 2016-06-28
- */
-/*!
-**  @addtogroup UART_module UART module documentation
-**  @{
-*/
-/* MODULE UART */
-
-// new types
-#include "UART.h"
-
-BOOL UART_Init(const uint32_t baudRate, const uint32_t moduleClk)
-{
-  uint16union_t SBR;              /*!<UART baud rate*/
-
-  register uint16_t brfa;         /*!<baud rate fine adjust*/
-
-  SIM_SCGC5 = 1<<13;		  /*!Enable PORTE clock gate control.UART2:13*/
-  PORTE_PCR16 = 3<<8;		  /*!Set MUX(bit 10 to 8) to 3(011) in PORTE16 to choose ALT3 to choose UART2_TX.*/
-  PORTE_PCR17 = 3<<8;		  /*!Set MUX(bit 10 to 8) to (011)3 in PORTE17 to choose ALT3 to choose UART2_RX.*/
-  SIM_SCGC4 = 1<<12;		  /*! Enable UART2 clock gate control. UART2:12.*/
-  UART2_C1 = 0x00;		  /*!8 bits data, Parity function disabled. PE*/
-  UART2_MODEM = 0x00;
-  SBR.l = (moduleClk/baudRate)/16;	 /*!Baud Rate Generation.*/
-  brfa = (((moduleClk<<5)/(baudRate<<4))-(SBR.l<<5));
-  UART2_C4 = (UART2_C4 &~(UART_C4_BRFA(0x1F)))|UART_C4_BRFA(brfa);
-  SBR.l &=(~BIT15TO13);                  /*!make bit 15 to 13 equal to 0. 0xXXXX & ~0xe000(0x1fff)it should be 000xxxxxxxxxxxxx*/
-  UART2_BDH = SBR.s.Hi;                  /*!type.h BDH is the first part of uint16union_t SBR*/
-  UART2_BDL = SBR.s.Lo;                  /*!type.h BDL is the second part of uint16union_t SBR*/
-  UART2_C2 = UART_C2_RE_MASK | UART_C2_TE_MASK;    	/*!Transmitter Enable, no interrupt.TE RE:00001100*/
-
-  UART2_C2 |= UART_C2_RIE_MASK;                         /*!enable receiver full interrupt*/
-  UART2_C2 &= ~UART_C2_TIE_MASK;                        /*!disable transmitter interrupt*/
-  NVICICPR1 = (1<<17);     /*! clear any pending interrupts on uart2:  by using table 3-5 the UART status source  IRQ is 49 NCIC number is 1, using function 49 mode 32*/
-  NVICISER1 = (1<<17);     /*!enable interrupts from UART module*/
-
-  return bTRUE;
-}
-
-
-BOOL UART_InChar(uint8_t * const dataPtr)
-{
-  /*!take out the data from RxFIFO into UART_InChar one by one*/
-  return FIFO_Get(&RxFIFO,dataPtr);
-}
-
-
-BOOL UART_OutChar(const uint8_t data)
-{
-  EnterCritical();
-  /*!put the data from UART_OutChar into TxFIFO one by one*/
-  if(FIFO_Put(&TxFIFO, data))
-  {
-    UART2_C2 |= UART_C2_TIE_MASK;                     /*!enable transmitter interrupt*/
-    ExitCritical();
-    return bTRUE;
-  }
-  else
-  {
-    ExitCritical();
-    return bFALSE;
-  }
-}
-
-/*!RDRF set, data is accepted and does into RxFIFO;TDRE is set, data retrieved into TxFIFO,and sent out*/
-void UART_Poll(void)
-{
-  uint8_t RDRF;                                        /*!< a 8 bit RDRF*/
-  uint8_t TDRE;                                        /*!< a 8 bit RDRF*/
-  /*make RDRF equal to 00X00000, (XXXXXXXX&00100000 = 00X00000)*/
-  RDRF = (UART2_S1 & RDRFSET);
-  /*if 00X00000=00100000,RDRF set, data is put into &RxFIFO*/
-  if(RDRF == RDRFSET)
-    FIFO_Put(&RxFIFO, UART2_D);
-  /*make TDRE equal to X0000000, (XXXXXXXX&10000000 = X0000000)*/
-  TDRE = (UART2_S1 & TDRESET);
-  /*if X0000000=10000000,TDRE set, data is taken out of &TxFIFO*/
-  if(TDRE == TDRESET)
-    FIFO_Get(&TxFIFO, (uint8_t *)&UART2_D);
-}
-void __attribute__ ((interrupt)) UART_ISR(void)
-{
-  uint8_t RDRF;                                          /*!< a 8 bit RDRF*/
-  uint8_t TDRE;                                          /*!< a 8 bit RDRF*/
-  /*make RDRF equal to 00X00000, (XXXXXXXX&00100000 = 00X00000)*/
-  RDRF = (UART2_S1 & RDRFSET);
-  /*if 00X00000=00100000,RDRF set, data is put into &RxFIFO*/
-  if(RDRF == RDRFSET)
-    FIFO_Put(&RxFIFO, UART2_D);
-  /*make TDRE equal to X0000000, (XXXXXXXX&10000000 = X0000000)*/
-  TDRE = (UART2_S1 & TDRESET);
-  /*if X0000000=10000000,TDRE set, data is taken out of &TxFIFO*/
-  if(TDRE == TDRESET)
-  {
-    if(!FIFO_Get(&TxFIFO, (uint8_t *)&UART2_D))           /*if error*/
-    UART2_C2 &= ~UART_C2_TIE_MASK;                        /*disable transmitter interrupt*/
-  }
-}
-
-/* END UART */
-/*!
-** @}
-*/
+/*! @file
+ *
+ *  @brief UART module: I/O routines for UART communications on the TWR-K70F120M.
+ *
+ *  This module contains the functions for operating the UART (serial port).
+ *
+ *  @author Liang Wang
+ *  @date 2016-06-28
+ */
+/*!
+**  @addtogroup UART_module UART module documentation
+**  @{
+*/
+/* MODULE UART */
+
+// new types
+#include <string.h>
+#include "UART.h"
+
+#if UART_RX_DMA
+#define RX_DMA_CHANNEL 1                           /*!< eDMA channel that empties UART2_D*/
+#define RX_DMA_SOURCE  6                           /*!< DMAMUX request source of the UART2 receiver*/
+
+FIFO_BUFFER(RxDMABuffer, UART_RX_DMA_SIZE);        /*!< circular buffer the eDMA channel keeps filling*/
+static uint16_t volatile RxDMABase;                /*!< free running count of bytes written up to the last half or major loop interrupt*/
+static uint16_t volatile RxDMATail;                /*!< free running count of bytes taken by the packet layer or the callback*/
+#else
+FIFO_DEFINE(RxFIFO, uint8_t, UART_RX_FIFO_SIZE)   /*!< RxFIFO only has the receive interrupt as producer and the packet layer as consumer*/
+
+static TRxFIFO RxFIFO;                             /*!< received bytes waiting for the packet layer*/
+#endif
+static TFIFO TxFIFO;                               /*!< bytes waiting to be transmitted*/
+static uint8_t TxFIFODepth;                        /*!< number of words the UART's transmit FIFO holds, 1 without a FIFO*/
+static uint8_t RxFIFODepth;                        /*!< number of words the UART's receive FIFO holds, 1 without a FIFO*/
+static uint32_t ModuleClk;                         /*!< module clock rate in Hz the baud rate divisors are worked out from*/
+static uint32_t volatile NewDivisor;               /*!< baud rate divisor to switch to once everything queued has been sent, 0 for none*/
+FIFO_BUFFER(TxBuffer, UART_TX_FIFO_SIZE);          /*!< storage for TxFIFO*/
+static TUARTStats Stats;                           /*!< counters, the TxFIFO ones are kept by TxFIFO itself*/
+static void (* volatile RxCallback)(const uint8_t);  /*!< takes received bytes in the interrupt instead of the receive FIFO, NULL if unused*/
+static void (* volatile TxCallback)(void);         /*!< tops up TxFIFO from the transmit interrupt, NULL if unused*/
+
+#if UART_TX_DMA
+#define TX_DMA_CHANNEL 0                           /*!< eDMA channel that feeds UART2_D, its interrupt is IRQ 0*/
+#define TX_DMA_SOURCE  7                           /*!< DMAMUX request source of the UART2 transmitter*/
+#define TX_DMA_MAX_COUNT 0x7FFF                    /*!< largest major loop count without channel linking*/
+
+static uint16_t volatile TxDMANbBytes;             /*!< number of bytes the running transfer sends, 0 when idle*/
+
+/*! @brief Starts an eDMA transfer of the oldest contiguous block of TxFIFO.
+ *
+ *  Stops the transmit DMA requests when TxFIFO is empty.
+ *  @note Must be called with interrupts disabled or from the transmit DMA interrupt.
+ */
+static void TxDMAStart(void)
+{
+  uint8_t *data;                                   /*!< first byte of the block*/
+  uint16_t nbBytes = FIFO_Peek(&TxFIFO, &data);    /*!< size of the block*/
+
+  if (nbBytes > TX_DMA_MAX_COUNT)
+    nbBytes = TX_DMA_MAX_COUNT;
+  TxDMANbBytes = nbBytes;
+  if (nbBytes == 0)
+  {
+    UART2_C2 &= ~UART_C2_TIE_MASK;                 /*!nothing left, stop asking for DMA requests*/
+    return;
+  }
+  DMA_SADDR(TX_DMA_CHANNEL) = (uint32_t)data;      /*!the bytes are read straight out of TxFIFO*/
+  DMA_CITER_ELINKNO(TX_DMA_CHANNEL) = nbBytes;     /*!one byte per request, nbBytes requests*/
+  DMA_BITER_ELINKNO(TX_DMA_CHANNEL) = nbBytes;
+  DMA_SERQ = TX_DMA_CHANNEL;                       /*!enable the channel's requests*/
+  UART2_C2 |= UART_C2_TIE_MASK;                    /*!TDRE now raises a DMA request instead of an interrupt*/
+}
+
+/*! @brief Sets up the eDMA channel that sends TxFIFO to UART2.
+ *
+ */
+static void TxDMAInit(void)
+{
+  SIM_SCGC6 |= SIM_SCGC6_DMAMUX0_MASK;             /*!enable the DMAMUX clock gate*/
+  SIM_SCGC7 |= SIM_SCGC7_DMA_MASK;                 /*!enable the eDMA clock gate*/
+  DMAMUX0_CHCFG(TX_DMA_CHANNEL) = 0;               /*!disable the channel while it is set up*/
+  DMA_ATTR(TX_DMA_CHANNEL) = DMA_ATTR_SSIZE(0) | DMA_ATTR_DSIZE(0);  /*!8-bit reads and writes*/
+  DMA_SOFF(TX_DMA_CHANNEL) = 1;                    /*!walk through TxFIFO*/
+  DMA_SLAST(TX_DMA_CHANNEL) = 0;                   /*!the source is set again for every block*/
+  DMA_DADDR(TX_DMA_CHANNEL) = (uint32_t)&UART2_D;  /*!always write the data register*/
+  DMA_DOFF(TX_DMA_CHANNEL) = 0;
+  DMA_DLAST_SGA(TX_DMA_CHANNEL) = 0;
+  DMA_NBYTES_MLNO(TX_DMA_CHANNEL) = 1;             /*!one byte per TDRE request*/
+  DMA_CSR(TX_DMA_CHANNEL) = DMA_CSR_INTMAJOR_MASK | DMA_CSR_DREQ_MASK;  /*!interrupt and stop at the end of the block*/
+  DMAMUX0_CHCFG(TX_DMA_CHANNEL) = DMAMUX_CHCFG_ENBL_MASK | DMAMUX_CHCFG_SOURCE(TX_DMA_SOURCE);
+  UART2_C5 |= UART_C5_TDMAS_MASK;                  /*!TIE selects DMA requests for the transmitter*/
+  TxDMANbBytes = 0;
+  NVICICPR0 = (1<<TX_DMA_CHANNEL);                 /*!clear any pending interrupts on DMA channel 0: IRQ 0, NVIC number 0*/
+  NVICISER0 = (1<<TX_DMA_CHANNEL);                 /*!enable interrupts from DMA channel 0*/
+}
+#endif
+
+#if UART_RX_DMA
+/*! @brief Sets up the eDMA channel that copies every received byte into RxDMABuffer.
+ *
+ *  The channel wraps back to the start of the buffer at the end of each major loop and never stops.
+ *  It interrupts halfway through and at the end of each loop, so a continuous stream is seen without an idle line.
+ */
+static void RxDMAInit(void)
+{
+  SIM_SCGC6 |= SIM_SCGC6_DMAMUX0_MASK;             /*!enable the DMAMUX clock gate*/
+  SIM_SCGC7 |= SIM_SCGC7_DMA_MASK;                 /*!enable the eDMA clock gate*/
+  DMAMUX0_CHCFG(RX_DMA_CHANNEL) = 0;               /*!disable the channel while it is set up*/
+  DMA_ATTR(RX_DMA_CHANNEL) = DMA_ATTR_SSIZE(0) | DMA_ATTR_DSIZE(0);  /*!8-bit reads and writes*/
+  DMA_SADDR(RX_DMA_CHANNEL) = (uint32_t)&UART2_D;  /*!always read the data register*/
+  DMA_SOFF(RX_DMA_CHANNEL) = 0;
+  DMA_SLAST(RX_DMA_CHANNEL) = 0;
+  DMA_DADDR(RX_DMA_CHANNEL) = (uint32_t)RxDMABuffer;
+  DMA_DOFF(RX_DMA_CHANNEL) = 1;                    /*!walk through the buffer*/
+  DMA_DLAST_SGA(RX_DMA_CHANNEL) = -UART_RX_DMA_SIZE;  /*!and go back to its start at the end*/
+  DMA_NBYTES_MLNO(RX_DMA_CHANNEL) = 1;             /*!one byte per RDRF request*/
+  DMA_CITER_ELINKNO(RX_DMA_CHANNEL) = UART_RX_DMA_SIZE;
+  DMA_BITER_ELINKNO(RX_DMA_CHANNEL) = UART_RX_DMA_SIZE;
+  DMA_CSR(RX_DMA_CHANNEL) = DMA_CSR_INTHALF_MASK | DMA_CSR_INTMAJOR_MASK;  /*!keep the requests enabled at the end of the loop*/
+  DMAMUX0_CHCFG(RX_DMA_CHANNEL) = DMAMUX_CHCFG_ENBL_MASK | DMAMUX_CHCFG_SOURCE(RX_DMA_SOURCE);
+  RxDMABase = 0;
+  RxDMATail = 0;
+  UART2_C5 |= UART_C5_RDMAS_MASK;                  /*!RIE selects DMA requests for the receiver*/
+  UART2_C2 |= UART_C2_ILIE_MASK;                   /*!the idle-line interrupt tells when a burst has arrived*/
+  NVICICPR0 = (1<<RX_DMA_CHANNEL);                 /*!clear any pending interrupts on DMA channel 1: IRQ 1, NVIC number 0*/
+  NVICISER0 = (1<<RX_DMA_CHANNEL);                 /*!enable interrupts from DMA channel 1*/
+  DMA_SERQ = RX_DMA_CHANNEL;                       /*!enable the channel's requests*/
+}
+
+/*! @brief Works out how many bytes the eDMA channel has written into RxDMABuffer since it was set up.
+ *
+ *  The position in the buffer comes from the major loop count. RxDMABase is never more than a loop behind it,
+ *  because the half and major loop interrupts move it every UART_RX_DMA_SIZE / 2 bytes.
+ *  @return uint16_t - The free running count of bytes written, it wraps around with RxDMATail.
+ */
+static uint16_t RxDMAWritten(void)
+{
+  uint16_t base, position;
+
+  /*!read the base again if the interrupt moved it while the count was read*/
+  do
+  {
+    base = RxDMABase;
+    position = (UART_RX_DMA_SIZE - DMA_CITER_ELINKNO(RX_DMA_CHANNEL)) & (UART_RX_DMA_SIZE - 1);
+  } while (base != RxDMABase);
+  return base + (uint16_t)((position - base) & (UART_RX_DMA_SIZE - 1));
+}
+
+/*! @brief Checks whether the eDMA channel has written over bytes that have not been taken yet.
+ *
+ *  If it has, every byte not taken is dropped and counted in RxDropped, the packet layer finds its feet again.
+ *  @param written The count of bytes written, from RxDMAWritten.
+ *  @return BOOL - TRUE if bytes were dropped.
+ *  @note Called only by the side that takes the bytes.
+ */
+static BOOL RxDMAOverrun(const uint16_t written)
+{
+  uint16_t tail = RxDMATail;
+
+  if ((uint16_t)(written - tail) <= UART_RX_DMA_SIZE)
+    return bFALSE;
+  Stats.RxDropped += (uint16_t)(written - tail);
+  RxDMATail = written;
+  return bTRUE;
+}
+#endif
+
+/*! @brief Works out the baud rate divisor for a baud rate.
+ *
+ *  The UART divides the module clock by 16 x (SBR + BRFA/32), so the divisor is kept in 32nds of SBR.
+ *  @param baudRate The desired baud rate in bits/sec.
+ *  @return uint32_t - SBR in bits 17 to 5 and BRFA in bits 4 to 0, 0 if the rate cannot be reached.
+ */
+static uint32_t BaudDivisor(const uint32_t baudRate)
+{
+  uint32_t divisor;
+
+  if (baudRate == 0)
+    return 0;
+  /*!round to the nearest 32nd, moduleClk x 32 / (16 x baudRate)*/
+  divisor = ((ModuleClk << 1) + (baudRate >> 1)) / baudRate;
+  /*!SBR is a 13-bit number that cannot be 0*/
+  if ((divisor >> 5) == 0 || (divisor >> 5) > 0x1FFF)
+    return 0;
+  return divisor;
+}
+
+/*! @brief Loads a baud rate divisor into the UART.
+ *
+ *  @param divisor SBR in bits 17 to 5 and BRFA in bits 4 to 0.
+ */
+static void SetBaudDivisor(const uint32_t divisor)
+{
+  uint16union_t SBR;              /*!<UART baud rate*/
+
+  SBR.l = divisor >> 5;           /*!Baud Rate Generation.*/
+  UART2_C4 = (UART2_C4 &~(UART_C4_BRFA(0x1F)))|UART_C4_BRFA(divisor & 0x1F);
+  SBR.l &=(~BIT15TO13);                  /*!make bit 15 to 13 equal to 0. 0xXXXX & ~0xe000(0x1fff)it should be 000xxxxxxxxxxxxx*/
+  UART2_BDH = SBR.s.Hi;                  /*!type.h BDH is the first part of uint16union_t SBR*/
+  UART2_BDL = SBR.s.Lo;                  /*!type.h BDL is the second part of uint16union_t SBR, the new rate takes effect on this write*/
+}
+
+/*! @brief Converts a PFIFO FIFO size field into a number of words.
+ *
+ *  @param size The TXFIFOSIZE or RXFIFOSIZE field.
+ *  @return uint8_t - 1 for a single data word, otherwise 2^(size+1) words.
+ */
+static uint8_t FIFODepth(const uint8_t size)
+{
+  return size ? (uint8_t)(1 << (size + 1)) : 1;
+}
+
+/*! @brief Enables the UART's own FIFOs, when it has them, with the configured watermarks.
+ *
+ *  UART2 on the K70 reports a depth of one word, in which case the single data register is used as before.
+ */
+static void HardwareFIFOInit(void)
+{
+  TxFIFODepth = FIFODepth((UART2_PFIFO & UART_PFIFO_TXFIFOSIZE_MASK) >> UART_PFIFO_TXFIFOSIZE_SHIFT);
+  RxFIFODepth = FIFODepth((UART2_PFIFO & UART_PFIFO_RXFIFOSIZE_MASK) >> UART_PFIFO_RXFIFOSIZE_SHIFT);
+#if UART_RX_DMA
+  RxFIFODepth = 1;                                 /*!the eDMA channel needs a request for every byte*/
+#endif
+  if (TxFIFODepth > 1)
+  {
+    UART2_PFIFO |= UART_PFIFO_TXFE_MASK;
+    UART2_TWFIFO = (UART_TX_WATERMARK < TxFIFODepth) ? UART_TX_WATERMARK : TxFIFODepth - 1;
+  }
+  if (RxFIFODepth > 1)
+  {
+    UART2_PFIFO |= UART_PFIFO_RXFE_MASK;
+    UART2_RWFIFO = (UART_RX_WATERMARK < RxFIFODepth) ? UART_RX_WATERMARK : RxFIFODepth;
+  }
+  UART2_CFIFO |= UART_CFIFO_TXFLUSH_MASK | UART_CFIFO_RXFLUSH_MASK;  /*!start with empty FIFOs*/
+}
+
+/*! @brief Counts the receive errors flagged in a reading of S1.
+ *
+ *  @param status The value read from UART2_S1.
+ */
+static void CountErrors(const uint8_t status)
+{
+  if (status & UART_S1_FE_MASK)
+    Stats.FramingErrors++;
+  if (status & UART_S1_OR_MASK)
+    Stats.Overruns++;
+  if (status & UART_S1_NF_MASK)
+    Stats.NoiseErrors++;
+}
+
+#if !UART_RX_DMA
+/*! @brief Moves every byte the UART has received into RxFIFO.
+ *
+ *  @note Called from the UART interrupt or UART_Poll.
+ */
+static void RxDrain(void)
+{
+  uint8_t status = UART2_S1;                       /*!reading S1 is the first half of clearing RDRF, IDLE and the error flags*/
+  uint8_t nbBytes;                                 /*!< number of bytes waiting in the UART*/
+  uint8_t data;                                    /*!< the received byte*/
+  uint16_t nbItems;                                /*!< number of bytes in RxFIFO*/
+
+  CountErrors(status);
+  if (RxFIFODepth > 1)
+    nbBytes = UART2_RCFIFO;
+  else
+    nbBytes = (status & UART_S1_RDRF_MASK) ? 1 : 0;
+  /*!reading D is the second half, and takes the byte out of the UART*/
+  while (nbBytes--)
+  {
+    data = UART2_D;
+    if (RxCallback)
+    {
+      RxCallback(data);
+      Stats.BytesIn++;
+    }
+    else if (!RxFIFO_Put(&RxFIFO, &data))
+      Stats.RxDropped++;
+  }
+  nbItems = RxFIFO_NbItems(&RxFIFO);
+  if (nbItems > Stats.RxHighWater)
+    Stats.RxHighWater = nbItems;
+  /*!an idle line with nothing left to read still needs a read of D to clear IDLE*/
+  if ((status & UART_S1_IDLE_MASK) && RxFIFODepth > 1 && UART2_RCFIFO == 0)
+  {
+    data = UART2_D;
+    UART2_CFIFO |= UART_CFIFO_RXFLUSH_MASK;         /*!the read of an empty FIFO leaves it misaligned*/
+    UART2_SFIFO = UART_SFIFO_RXUF_MASK;             /*!and flags an underflow, which is of no interest*/
+  }
+}
+#endif
+
+#if UART_RX_DMA
+/*! @brief Hands the bytes the eDMA channel has written so far to the callback, if there is one.
+ *
+ *  Without a callback the packet layer takes them with UART_InChar, which looks at the channel itself.
+ *  @note Called from the UART and receive DMA interrupts, which have the same priority.
+ */
+static void RxDMADeliver(void)
+{
+  uint16_t written = RxDMAWritten();
+  uint16_t nbBytes = (uint16_t)(written - RxDMATail);  /*!< number of bytes waiting*/
+
+  if (nbBytes > Stats.RxHighWater)
+    Stats.RxHighWater = (nbBytes > UART_RX_DMA_SIZE) ? UART_RX_DMA_SIZE : nbBytes;
+  if (!RxCallback || RxDMAOverrun(written))
+    return;
+  /*!the callback takes them straight away, so nothing waits for the packet layer*/
+  while (RxDMATail != written)
+  {
+    RxCallback(RxDMABuffer[RxDMATail & (UART_RX_DMA_SIZE - 1)]);
+    RxDMATail++;
+    Stats.BytesIn++;
+  }
+}
+
+/*! @brief Delivers a burst once the line goes idle after it.
+ *
+ *  The CPU never reads D here: a read could take a byte that has just arrived for the eDMA channel. IDLE is
+ *  cleared by reading S1 with it set and then reading D, so the channel's read of the next byte finishes it.
+ *  Until then the idle-line interrupt is turned off, and the first byte of the next burst raises a receive
+ *  interrupt instead of a DMA request, which hands it back to the channel and turns the idle line on again.
+ *  @note Called from the UART interrupt.
+ */
+static void RxDMAIdle(void)
+{
+  uint8_t status = UART2_S1;                       /*!reading S1 is the first half of clearing IDLE and the error flags*/
+
+  CountErrors(status);
+  if (!(UART2_C5 & UART_C5_RDMAS_MASK))
+  {
+    /*!the first byte after an idle line: the channel takes it and its read of D clears IDLE*/
+    if (status & UART_S1_RDRF_MASK)
+    {
+      UART2_C5 |= UART_C5_RDMAS_MASK;
+      UART2_C2 |= UART_C2_ILIE_MASK;
+    }
+    return;
+  }
+  if (!(status & UART_S1_IDLE_MASK) || !(UART2_C2 & UART_C2_ILIE_MASK))
+    return;
+  RxDMADeliver();
+  /*!a new burst has begun already, the channel's read of its first byte clears IDLE*/
+  if (status & UART_S1_RDRF_MASK)
+    return;
+  UART2_C2 &= ~UART_C2_ILIE_MASK;
+  UART2_C5 &= ~UART_C5_RDMAS_MASK;
+  /*!a byte the channel took before the switch has cleared IDLE, and there may be no other to turn it on again*/
+  if (!(UART2_S1 & UART_S1_IDLE_MASK))
+  {
+    UART2_C5 |= UART_C5_RDMAS_MASK;
+    UART2_C2 |= UART_C2_ILIE_MASK;
+  }
+}
+#endif
+
+#if !UART_TX_DMA
+/*! @brief Fills the UART with as many bytes from TxFIFO as it has room for.
+ *
+ *  Disables the transmitter interrupt when TxFIFO is empty.
+ *  @note Called from the UART interrupt or UART_Poll.
+ */
+static void TxFill(void)
+{
+  uint8_t *data;                                   /*!< oldest contiguous bytes of TxFIFO*/
+  uint16_t nbBytes;                                /*!< number of them*/
+  uint8_t room;                                    /*!< number of bytes the UART can take*/
+  uint8_t i;
+
+  if (!(UART2_S1 & UART_S1_TDRE_MASK))             /*!reading S1 with TDRE set is the first half of clearing it*/
+    return;
+  room = (TxFIFODepth > 1) ? TxFIFODepth - UART2_TCFIFO : 1;
+  /*!give the callback its chance to top up TxFIFO before it is found empty*/
+  if (TxCallback)
+    TxCallback();
+  nbBytes = FIFO_Peek(&TxFIFO, &data);
+  if (nbBytes == 0)
+  {
+    UART2_C2 &= ~UART_C2_TIE_MASK;                 /*!nothing left to send, disable transmitter interrupt*/
+    return;
+  }
+  if (nbBytes > room)
+    nbBytes = room;
+  /*!writing D is the second half, and queues the byte*/
+  for (i = 0; i < nbBytes; i++)
+    UART2_D = data[i];
+  FIFO_Release(&TxFIFO, nbBytes);
+  Stats.BytesOut += nbBytes;
+}
+#endif
+
+/*! @brief Starts sending what has been put in TxFIFO.
+ *
+ *  @note Must be called with interrupts disabled.
+ */
+static void TxStart(void)
+{
+#if UART_TX_DMA
+  /*!a running transfer carries on with the new bytes from its interrupt*/
+  if (TxDMANbBytes == 0)
+    TxDMAStart();
+#else
+  UART2_C2 |= UART_C2_TIE_MASK;                    /*!enable transmitter interrupt*/
+#endif
+}
+
+BOOL UART_Init(const uint32_t baudRate, const uint32_t moduleClk)
+{
+  uint32_t divisor;               /*!<SBR and BRFA*/
+
+  ModuleClk = moduleClk;
+  NewDivisor = 0;
+  RxCallback = NULL;
+  TxCallback = NULL;
+  divisor = BaudDivisor(baudRate);
+  if (divisor == 0)
+    return bFALSE;
+
+#if !UART_RX_DMA
+  RxFIFO_Init(&RxFIFO);
+#endif
+  FIFO_Init(&TxFIFO, TxBuffer, sizeof(TxBuffer));
+  memset(&Stats, 0, sizeof(Stats));
+
+  SIM_SCGC5 = 1<<13;		  /*!Enable PORTE clock gate control.UART2:13*/
+  PORTE_PCR16 = 3<<8;		  /*!Set MUX(bit 10 to 8) to 3(011) in PORTE16 to choose ALT3 to choose UART2_TX.*/
+  PORTE_PCR17 = 3<<8;		  /*!Set MUX(bit 10 to 8) to (011)3 in PORTE17 to choose ALT3 to choose UART2_RX.*/
+  SIM_SCGC4 = 1<<12;		  /*! Enable UART2 clock gate control. UART2:12.*/
+  UART2_C1 = 0x00;		  /*!8 bits data, Parity function disabled. PE*/
+  UART2_MODEM = 0x00;
+  SetBaudDivisor(divisor);
+  HardwareFIFOInit();                    /*!must be done while the transmitter and receiver are disabled*/
+  UART2_C2 = UART_C2_RE_MASK | UART_C2_TE_MASK;    	/*!Transmitter Enable, no interrupt.TE RE:00001100*/
+
+  UART2_C2 |= UART_C2_RIE_MASK;                         /*!enable receiver full interrupt*/
+#if !UART_RX_DMA
+  if (RxFIFODepth > 1 && UART2_RWFIFO > 1)
+    UART2_C2 |= UART_C2_ILIE_MASK;                      /*!collect the bytes left below the watermark at the end of a burst*/
+#endif
+  UART2_C2 &= ~UART_C2_TIE_MASK;                        /*!disable transmitter interrupt*/
+  NVICICPR1 = (1<<17);     /*! clear any pending interrupts on uart2:  by using table 3-5 the UART status source  IRQ is 49 NCIC number is 1, using function 49 mode 32*/
+  NVICISER1 = (1<<17);     /*!enable interrupts from UART module*/
+#if UART_TX_DMA
+  TxDMAInit();
+#endif
+#if UART_RX_DMA
+  RxDMAInit();
+#endif
+
+  return bTRUE;
+}
+
+
+void UART_SetRxCallback(void (*userFunction)(const uint8_t))
+{
+  RxCallback = userFunction;
+}
+
+
+void UART_SetTxCallback(void (*userFunction)(void))
+{
+  TxCallback = userFunction;
+}
+
+
+BOOL UART_InChar(uint8_t * const dataPtr)
+{
+#if UART_RX_DMA
+  /*!only the packet layer moves RxDMATail, and it reads how far the channel has got straight from the channel*/
+  uint16_t tail = RxDMATail;
+  uint16_t written = RxDMAWritten();
+
+  if (tail == written || RxDMAOverrun(written))
+    return bFALSE;
+  /*!do not read the buffer before the count was seen to cover it*/
+  FIFO_MEMORY_BARRIER();
+  *dataPtr = RxDMABuffer[tail & (UART_RX_DMA_SIZE - 1)];
+  /*!the channel may have come round and written over the byte while it was read*/
+  FIFO_MEMORY_BARRIER();
+  if (RxDMAOverrun(RxDMAWritten()))
+    return bFALSE;
+  RxDMATail = tail + 1;
+#else
+  /*!take out the data from RxFIFO into UART_InChar one by one, no critical section is needed*/
+  if (!RxFIFO_Get(&RxFIFO,dataPtr))
+    return bFALSE;
+#endif
+  Stats.BytesIn++;
+  return bTRUE;
+}
+
+
+uint16_t UART_InNbBytes(void)
+{
+#if UART_RX_DMA
+  uint16_t nbBytes = (uint16_t)(RxDMAWritten() - RxDMATail);
+
+  return (nbBytes > UART_RX_DMA_SIZE) ? UART_RX_DMA_SIZE : nbBytes;
+#else
+  return RxFIFO_NbItems(&RxFIFO);
+#endif
+}
+
+
+uint16_t UART_OutNbBytes(void)
+{
+  return TxFIFO.NbBytes;
+}
+
+
+BOOL UART_OutChar(const uint8_t data)
+{
+  EnterCritical();
+  /*!put the data from UART_OutChar into TxFIFO one by one, but nothing more once a baud rate change is waiting*/
+  if(!NewDivisor && FIFO_Put(&TxFIFO, data))
+  {
+    TxStart();
+    ExitCritical();
+    return bTRUE;
+  }
+  else
+  {
+    ExitCritical();
+    return bFALSE;
+  }
+}
+
+BOOL UART_OutBlock(const uint8_t * const data, const uint16_t nbBytes)
+{
+  BOOL success;
+
+  EnterCritical();
+  /*!put the whole block into TxFIFO with a single critical section*/
+  success = !NewDivisor && FIFO_PutBlock(&TxFIFO, data, nbBytes);
+  if(success)
+    TxStart();
+  ExitCritical();
+  return success;
+}
+
+BOOL UART_OutReserve(const uint16_t nbBytes, TFIFOSpan * const span)
+{
+  /*!nothing more is queued once a baud rate change is waiting*/
+  if (NewDivisor)
+    return bFALSE;
+  return FIFO_Reserve(&TxFIFO, nbBytes, span);
+}
+
+
+uint32_t UART_AchievedBaudRate(const uint32_t baudRate)
+{
+  uint32_t divisor = BaudDivisor(baudRate);
+
+  if (divisor == 0)
+    return 0;
+  return ((ModuleClk << 1) + (divisor >> 1)) / divisor;
+}
+
+
+BOOL UART_SetBaudRate(const uint32_t baudRate)
+{
+  uint32_t divisor = BaudDivisor(baudRate);
+
+  if (divisor == 0)
+    return bFALSE;
+  EnterCritical();
+  /*!switch when the transmitter has gone idle with nothing left in TxFIFO, UART_ISR sees it through TC*/
+  NewDivisor = divisor;
+  UART2_C2 |= UART_C2_TCIE_MASK;
+  ExitCritical();
+  return bTRUE;
+}
+
+
+BOOL UART_BaudRatePending(void)
+{
+  return NewDivisor != 0;
+}
+
+
+void UART_GetStats(TUARTStats * const stats)
+{
+  EnterCritical();
+  *stats = Stats;
+  stats->TxHighWater = TxFIFO.HighWater;
+  stats->TxDropped = TxFIFO.NbDropped;
+  ExitCritical();
+}
+
+
+void UART_OutCommit(const uint16_t nbBytes)
+{
+  EnterCritical();
+  /*!the committed bytes become visible to the transmitter all at once*/
+  FIFO_Commit(&TxFIFO, nbBytes);
+  if (nbBytes)
+    TxStart();
+  ExitCritical();
+}
+
+/*!RDRF set, data is accepted and does into RxFIFO;TDRE is set, data retrieved into TxFIFO,and sent out*/
+void UART_Poll(void)
+{
+#if !UART_RX_DMA
+  RxDrain();
+#endif
+#if !UART_TX_DMA
+  TxFill();
+#endif
+}
+
+void __attribute__ ((interrupt)) UART_ISR(void)
+{
+  /*!a baud rate change waits for the last queued byte to leave the wire*/
+  if ((UART2_C2 & UART_C2_TCIE_MASK) && (UART2_S1 & UART_S1_TC_MASK) && TxFIFO.NbBytes == 0)
+  {
+    UART2_C2 &= ~(UART_C2_TCIE_MASK | UART_C2_TE_MASK | UART_C2_RE_MASK);  /*!the divisors are changed with the UART stopped*/
+    SetBaudDivisor(NewDivisor);
+    NewDivisor = 0;
+    UART2_C2 |= UART_C2_TE_MASK | UART_C2_RE_MASK;
+    /*!whatever was held back during the change can go now*/
+    if (TxCallback)
+      TxCallback();
+  }
+#if UART_RX_DMA
+  RxDMAIdle();
+#else
+  /*!take every byte that has arrived, not just one*/
+  RxDrain();
+#endif
+#if !UART_TX_DMA
+  /*!and fill every free place in the transmitter*/
+  if (UART2_C2 & UART_C2_TIE_MASK)
+    TxFill();
+#endif
+}
+
+#if UART_RX_DMA
+void __attribute__ ((interrupt)) UART_RxDMA_ISR(void)
+{
+  DMA_CINT = RX_DMA_CHANNEL;                             /*!clear the channel's interrupt request*/
+  RxDMABase += UART_RX_DMA_SIZE / 2;                     /*!it comes every half loop*/
+  RxDMADeliver();
+}
+#endif
+
+#if UART_TX_DMA
+void __attribute__ ((interrupt)) UART_TxDMA_ISR(void)
+{
+  DMA_CINT = TX_DMA_CHANNEL;                             /*!clear the channel's interrupt request*/
+  FIFO_Release(&TxFIFO, TxDMANbBytes);                   /*!the block has been sent, its room can be reused*/
+  Stats.BytesOut += TxDMANbBytes;
+  if (TxCallback)
+    TxCallback();                                        /*!TxDMANbBytes is still set, so this does not start a transfer itself*/
+  TxDMAStart();                                          /*!carry on with whatever was put in meanwhile*/
+}
+#endif
+
+/* END UART */
+/*!
+** @}
+*/
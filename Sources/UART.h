@@ -1,61 +1,211 @@
-/*! @file
- *
- *  @brief I/O routines for UART communications on the TWR-K70F120M.
- *
- *  This contains the functions for operating the UART (serial port).
- *
- *  @author PMcL
- *  @date 2015-07-23
- */
-
-#ifndef UART_H
-#define UART_H
-
-// new types
-#include "types.h"
-#include "FIFO.h"
-#include "MK70F12.h"
-#define BIT15TO13 0xe000
-#define RDRFSET 0x20
-#define TDRESET 0x80
-static TFIFO RxFIFO;
-static TFIFO TxFIFO;
-
-/*! @brief Sets up the UART interface before first use.
- *
- *  @param baudRate The desired baud rate in bits/sec.
- *  @param moduleClk The module clock rate in Hz.
- *  @return BOOL - TRUE if the UART was successfully initialized.
- */
-BOOL UART_Init(const uint32_t baudRate, const uint32_t moduleClk);
- 
-/*! @brief Get a character from the receive FIFO if it is not empty.
- *
- *  @param dataPtr A pointer to memory to store the retrieved byte.
- *  @return BOOL - TRUE if the receive FIFO returned a character.
- *  @note Assumes that UART_Init has been called.
- */
-BOOL UART_InChar(uint8_t* const dataPtr);
- 
-/*! @brief Put a byte in the transmit FIFO if it is not full.
- *
- *  @param data The byte to be placed in the transmit FIFO.
- *  @return BOOL - TRUE if the data was placed in the transmit FIFO.
- *  @note Assumes that UART_Init has been called.
- */
-BOOL UART_OutChar(const uint8_t data);
-
-/*! @brief Poll the UART status register to try and receive and/or transmit one character.
- *
- *  @return void
- *  @note Assumes that UART_Init has been called.
- */
-void UART_Poll(void);
-
-/*! @brief Interrupt service routine for the UART.
- *
- *  @note Assumes the transmit and receive FIFOs have been initialized.
- */
-void __attribute__ ((interrupt)) UART_ISR(void);
-
-#endif
+/*! @file
+ *
+ *  @brief I/O routines for UART communications on the TWR-K70F120M.
+ *
+ *  This contains the functions for operating the UART (serial port).
+ *
+ *  @author PMcL
+ *  @date 2015-07-23
+ */
+
+#ifndef UART_H
+#define UART_H
+
+// new types
+#include "types.h"
+#include "FIFO.h"
+#include "MK70F12.h"
+#define BIT15TO13 0xe000
+#define RDRFSET 0x20
+#define TDRESET 0x80
+// Number of bytes in the receive and transmit FIFOs, each a power of two
+#define UART_RX_FIFO_SIZE 64
+#define UART_TX_FIFO_SIZE 2048
+
+// Watermarks of the UART's own transmit and receive FIFOs, used when the hardware has FIFOs deeper than one word:
+// the transmit interrupt comes when at most UART_TX_WATERMARK words are left to send,
+// the receive interrupt when at least UART_RX_WATERMARK words have arrived (the idle line collects the rest)
+#define UART_TX_WATERMARK 2
+#define UART_RX_WATERMARK 4
+
+// Set to 1 to send TxFIFO with eDMA transfers, one interrupt per block instead of one per byte
+#ifndef UART_TX_DMA
+#define UART_TX_DMA 0
+#endif
+
+// Set to 1 to receive with an eDMA transfer that fills a circular buffer of UART_RX_DMA_SIZE bytes,
+// so there is no per-byte interrupt; the half and major loop interrupts and the idle line hand bytes to a callback
+#ifndef UART_RX_DMA
+#define UART_RX_DMA 0
+#endif
+
+// Number of bytes in the eDMA receive buffer, a power of two; bytes not taken within this many are dropped
+#define UART_RX_DMA_SIZE 512
+
+/*!
+ * @struct TUARTStats
+ *
+ * The counters wrap around, so rates are worked out from the difference between two readings. The byte counts
+ * are 32 bits, so that even at the highest baud rates they take hours to wrap; the rest are 16 bits.
+ */
+typedef struct
+{
+  uint32_t BytesIn;		/*!< The number of received bytes handed to the packet layer */
+  uint32_t BytesOut;		/*!< The number of bytes handed to the UART for transmission */
+  uint16_t RxHighWater;		/*!< The most bytes the receive buffer has held */
+  uint16_t RxDropped;		/*!< The number of received bytes lost because the receive buffer was full, or written over in eDMA mode */
+  uint16_t TxHighWater;		/*!< The most bytes TxFIFO has held */
+  uint16_t TxDropped;		/*!< The number of puts into TxFIFO refused because it was full */
+  uint16_t FramingErrors;	/*!< The number of times the UART saw a framing error */
+  uint16_t Overruns;		/*!< The number of times the UART received a byte with no room left for it */
+  uint16_t NoiseErrors;		/*!< The number of times the UART saw noise on the line */
+} TUARTStats;
+
+/*! @brief Sets up the UART interface before first use.
+ *
+ *  @param baudRate The desired baud rate in bits/sec.
+ *  @param moduleClk The module clock rate in Hz.
+ *  @return BOOL - TRUE if the UART was successfully initialized, FALSE if the baud rate cannot be reached.
+ */
+BOOL UART_Init(const uint32_t baudRate, const uint32_t moduleClk);
+ 
+/*! @brief Hands every received byte to a function called from the UART interrupt, instead of the receive FIFO.
+ *
+ *  @param userFunction The function each byte is passed to, NULL to go back to the receive FIFO.
+ *  @return void
+ *  @note Assumes that UART_Init has been called.
+ */
+void UART_SetRxCallback(void (*userFunction)(const uint8_t));
+
+/*! @brief Calls a function from the transmit interrupt whenever bytes have been taken out of the transmit FIFO.
+ *
+ *  The function can top the transmit FIFO up, e.g. with lower priority data held back until the transmitter
+ *  is nearly idle. It is also called once a baud rate change has been made.
+ *  @param userFunction The function to call, NULL for none.
+ *  @return void
+ *  @note Assumes that UART_Init has been called.
+ */
+void UART_SetTxCallback(void (*userFunction)(void));
+
+/*! @brief Get a character from the receive FIFO if it is not empty.
+ *
+ *  @param dataPtr A pointer to memory to store the retrieved byte.
+ *  @return BOOL - TRUE if the receive FIFO returned a character.
+ *  @note Assumes that UART_Init has been called.
+ */
+BOOL UART_InChar(uint8_t* const dataPtr);
+
+/*! @brief Get the number of received bytes waiting to be read with UART_InChar.
+ *
+ *  @return uint16_t - The number of bytes that can be read.
+ *  @note Assumes that UART_Init has been called.
+ */
+uint16_t UART_InNbBytes(void);
+ 
+/*! @brief Get the number of bytes in the transmit FIFO that have not been sent yet.
+ *
+ *  @return uint16_t - The number of committed bytes waiting to be sent.
+ *  @note Assumes that UART_Init has been called.
+ */
+uint16_t UART_OutNbBytes(void);
+ 
+/*! @brief Put a byte in the transmit FIFO if it is not full.
+ *
+ *  @param data The byte to be placed in the transmit FIFO.
+ *  @return BOOL - TRUE if the data was placed in the transmit FIFO.
+ *  @note Assumes that UART_Init has been called.
+ */
+BOOL UART_OutChar(const uint8_t data);
+
+/*! @brief Put a block of bytes in the transmit FIFO if there is room for all of them.
+ *
+ *  @param data A pointer to the bytes to be placed in the transmit FIFO.
+ *  @param nbBytes The number of bytes to be placed in the transmit FIFO.
+ *  @return BOOL - TRUE if the whole block was placed in the transmit FIFO.
+ *  @note Assumes that UART_Init has been called.
+ */
+BOOL UART_OutBlock(const uint8_t* const data, const uint16_t nbBytes);
+
+/*! @brief Reserve room in the transmit FIFO so that a frame can be encoded straight into it.
+ *
+ *  @param nbBytes The number of bytes to reserve.
+ *  @param span A pointer to a span that is set to the reserved part of the transmit FIFO.
+ *  @return BOOL - TRUE if the room was reserved.
+ *  @note Assumes that UART_Init has been called. Must be followed by UART_OutCommit.
+ */
+BOOL UART_OutReserve(const uint16_t nbBytes, TFIFOSpan* const span);
+
+/*! @brief Commit the bytes written into a reservation of the transmit FIFO and start sending them.
+ *
+ *  @param nbBytes The number of reserved bytes to send, 0 to cancel the reservation.
+ *  @return void
+ *  @note Assumes that UART_OutReserve has been called.
+ */
+void UART_OutCommit(const uint16_t nbBytes);
+
+/*! @brief Works out the baud rate the UART would really run at for a desired baud rate.
+ *
+ *  @param baudRate The desired baud rate in bits/sec.
+ *  @return uint32_t - The baud rate the SBR and BRFA divisors give, 0 if the rate cannot be reached.
+ *  @note Assumes that UART_Init has been called.
+ */
+uint32_t UART_AchievedBaudRate(const uint32_t baudRate);
+
+/*! @brief Changes the baud rate as soon as everything in the transmit FIFO has been sent.
+ *
+ *  From the call until the change, the transmit functions refuse new bytes, so that nothing queued
+ *  after the call can go out at the old baud rate.
+ *  @param baudRate The desired baud rate in bits/sec.
+ *  @return BOOL - TRUE if the change has been scheduled, FALSE if the rate cannot be reached.
+ *  @note Assumes that UART_Init has been called.
+ */
+BOOL UART_SetBaudRate(const uint32_t baudRate);
+
+/*! @brief Tells whether a baud rate change is still waiting for the transmit FIFO to empty.
+ *
+ *  @return BOOL - TRUE while the transmit functions refuse new bytes because of a change.
+ *  @note Assumes that UART_Init has been called.
+ */
+BOOL UART_BaudRatePending(void);
+
+/*! @brief Takes a snapshot of the UART and FIFO counters.
+ *
+ *  @param stats A pointer to the structure the counters are copied into.
+ *  @return void
+ *  @note Assumes that UART_Init has been called.
+ */
+void UART_GetStats(TUARTStats* const stats);
+
+/*! @brief Poll the UART status register to try and receive and/or transmit one character.
+ *
+ *  @return void
+ *  @note Assumes that UART_Init has been called.
+ */
+void UART_Poll(void);
+
+/*! @brief Interrupt service routine for the UART.
+ *
+ *  @note Assumes the transmit and receive FIFOs have been initialized.
+ */
+void __attribute__ ((interrupt)) UART_ISR(void);
+
+#if UART_TX_DMA
+/*! @brief Interrupt service routine for the end of a UART transmit eDMA transfer.
+ *
+ *  Frees the bytes that were sent and starts a transfer of the next contiguous block of the transmit FIFO.
+ *  @note Assumes the UART has been initialized with UART_TX_DMA set.
+ */
+void __attribute__ ((interrupt)) UART_TxDMA_ISR(void);
+#endif
+
+#if UART_RX_DMA
+/*! @brief Interrupt service routine for the UART receive eDMA channel, halfway through and at the end of its loop.
+ *
+ *  Hands the bytes received so far to the callback set with UART_SetRxCallback, so that a stream with no idle
+ *  line in it is still delivered.
+ *  @note Assumes the UART has been initialized with UART_RX_DMA set.
+ */
+void __attribute__ ((interrupt)) UART_RxDMA_ISR(void);
+#endif
+
+#endif
@@ -0,0 +1,85 @@
+/*! @file
+ *
+ *  @brief command module: Routines to dispatch received packets to the handlers registered for their commands.
+ *
+ *  This module contains the handler table and the per-command counters.
+ *
+ *  @author Liang Wang
+ *  @date 2016-07-25
+ */
+/*!
+**  @addtogroup command_module command module documentation
+**  @{
+*/
+/* MODULE command */
+#include <string.h>
+#include "command.h"
+#include "MK70F12.h"
+
+// The Cortex-M4 data watchpoint and trace unit counts core clock cycles
+#ifndef DWT_CYCCNT
+#define DWT_CTRL   (*(volatile uint32_t*)0xE0001000)
+#define DWT_CYCCNT (*(volatile uint32_t*)0xE0001004)
+#define SCB_DEMCR  (*(volatile uint32_t*)0xE000EDFC)
+#endif
+#define DWT_CTRL_CYCCNTENA_MASK 0x1u
+#define SCB_DEMCR_TRCENA_MASK   0x01000000u
+
+static TCommandHandler Handlers[COMMAND_NB];          /*!< the handler of every command, NULL if it has none*/
+static TCommandStats Stats[COMMAND_NB];               /*!< counters of every command*/
+
+
+BOOL Command_Init(void)
+{
+  memset(Handlers, 0, sizeof(Handlers));
+  memset(Stats, 0, sizeof(Stats));
+  /*!the cycle counter only runs with trace enabled*/
+  SCB_DEMCR |= SCB_DEMCR_TRCENA_MASK;
+  DWT_CTRL |= DWT_CTRL_CYCCNTENA_MASK;
+  return bTRUE;
+}
+
+
+BOOL Command_Register(const uint8_t command, const TCommandHandler handler)
+{
+  /*!two modules claiming the same command is a mistake, so the first one keeps it*/
+  if (command >= COMMAND_NB || Handlers[command] || !handler)
+    return bFALSE;
+  Handlers[command] = handler;
+  return bTRUE;
+}
+
+
+BOOL Command_Dispatch(const TPacket* const packet)
+{
+  uint8_t command = packet->packetStruct.command & (COMMAND_NB - 1);  /*!the acknowledgement bit is not part of the command*/
+  TCommandStats *stats = &Stats[command];
+  uint32_t start, cycles;
+  BOOL carriedOut;
+
+  if (!Handlers[command])
+    return bFALSE;
+  start = DWT_CYCCNT;
+  carriedOut = Handlers[command](packet);
+  /*!unsigned subtraction gives the right answer across a wrap of the counter*/
+  cycles = DWT_CYCCNT - start;
+  stats->NbCalls++;
+  stats->NbCycles += cycles;
+  if (cycles > stats->MaxCycles)
+    stats->MaxCycles = cycles;
+  return carriedOut;
+}
+
+
+BOOL Command_GetStats(const uint8_t command, TCommandStats* const stats)
+{
+  if (command >= COMMAND_NB)
+    return bFALSE;
+  *stats = Stats[command];
+  return bTRUE;
+}
+
+/* END command */
+/*!
+** @}
+*/
@@ -0,0 +1,71 @@
+/*! @file
+ *
+ *  @brief Routines to dispatch received packets to the handlers registered for their commands.
+ *
+ *  This contains the functions for a 128-entry handler table indexed by command, with the number
+ *  of calls and the cycles spent counted for every command.
+ *
+ *  @author Liang Wang
+ *  @date 2016-07-25
+ */
+
+#ifndef COMMAND_H
+#define COMMAND_H
+
+// new types
+#include "types.h"
+#include "packet.h"
+
+// Number of commands, the acknowledgement bit is not part of the command
+#define COMMAND_NB 128
+
+/*! @brief A command handler.
+ *
+ *  @param packet The received packet.
+ *  @return BOOL - TRUE if the command was carried out.
+ */
+typedef BOOL (*TCommandHandler)(const TPacket* const packet);
+
+/*!
+ * @struct TCommandStats
+ */
+typedef struct
+{
+  uint32_t NbCalls;		/*!< The number of times the handler has been called */
+  uint32_t NbCycles;		/*!< The core clock cycles spent in the handler over all calls, wraps around */
+  uint32_t MaxCycles;		/*!< The most core clock cycles spent in one call */
+} TCommandStats;
+
+/*! @brief Clears the handler table and starts the cycle counter.
+ *
+ *  @return BOOL - TRUE if the command module was successfully initialized.
+ */
+BOOL Command_Init(void);
+
+/*! @brief Registers the handler for a command.
+ *
+ *  @param command The command, 0 to COMMAND_NB - 1.
+ *  @param handler The function that handles the command.
+ *  @return BOOL - TRUE if the handler was registered, FALSE if the command is out of range or already has a handler.
+ *  @note Assumes that Command_Init has been called.
+ */
+BOOL Command_Register(const uint8_t command, const TCommandHandler handler);
+
+/*! @brief Calls the handler registered for the command of a packet.
+ *
+ *  @param packet The received packet, its acknowledgement bit is ignored.
+ *  @return BOOL - What the handler returned, FALSE if no handler is registered.
+ *  @note Assumes that Command_Init has been called.
+ */
+BOOL Command_Dispatch(const TPacket* const packet);
+
+/*! @brief Gets the number of calls and cycles counted for a command.
+ *
+ *  @param command The command, 0 to COMMAND_NB - 1.
+ *  @param stats A pointer to the structure the counters are copied into.
+ *  @return BOOL - TRUE if the command is in range.
+ *  @note Assumes that Command_Init has been called.
+ */
+BOOL Command_GetStats(const uint8_t command, TCommandStats* const stats);
+
+#endif
@@ -0,0 +1,161 @@
+/*! @file
+ *
+ *  @brief delta module: Routines to delta encode accelerometer samples into nibbles, and to decode them again.
+ *
+ *  This module contains the encoder used by the stream module and the matching decoder for the PC side.
+ *
+ *  @author Liang Wang
+ *  @date 2016-08-05
+ */
+/*!
+**  @addtogroup delta_module delta module documentation
+**  @{
+*/
+/* MODULE delta */
+#include "delta.h"
+
+#define ESCAPE 0x8        /*!< nibble that says an 8-bit change follows*/
+
+/*! @brief Writes a nibble after the header.
+ *
+ *  @param encoder The encoder, with room for the nibble.
+ *  @param nibble The nibble, in the low four bits.
+ */
+static void PutNibble(TDeltaEncoder* const encoder, const uint8_t nibble)
+{
+  uint8_t *byte = &encoder->Buffer[DELTA_HEADER_NB_BYTES + (encoder->NbNibbles >> 1)];
+
+  /*!high nibble first, which also clears the low nibble used as padding*/
+  if (encoder->NbNibbles & 1)
+    *byte |= nibble & 0x0F;
+  else
+    *byte = nibble << 4;
+  encoder->NbNibbles++;
+}
+
+/*! @brief Writes a change as one nibble, or as an escaped byte.
+ *
+ *  @param encoder The encoder, with room for three nibbles.
+ *  @param change The change, modulo 256.
+ */
+static void PutChange(TDeltaEncoder* const encoder, const uint8_t change)
+{
+  int8_t value = (int8_t)change;
+
+  if (value >= -7 && value <= 7)
+    PutNibble(encoder, (uint8_t)value);
+  else
+  {
+    PutNibble(encoder, ESCAPE);
+    PutNibble(encoder, change >> 4);
+    PutNibble(encoder, change);
+  }
+}
+
+/*! @brief Reads a nibble after the header.
+ *
+ *  @param data The encoded data.
+ *  @param nibble A pointer to the index of the nibble, moved on past it.
+ *  @return uint8_t - The nibble.
+ */
+static uint8_t GetNibble(const uint8_t* const data, uint16_t* const nibble)
+{
+  uint8_t byte = data[DELTA_HEADER_NB_BYTES + (*nibble >> 1)];
+
+  return ((*nibble)++ & 1) ? (byte & 0x0F) : (byte >> 4);
+}
+
+
+void Delta_Start(TDeltaEncoder* const encoder, uint8_t* const buffer, const uint16_t size, const uint16_t time, const uint8_t xyz[3])
+{
+  encoder->Buffer = buffer;
+  encoder->Size = size;
+  encoder->NbNibbles = 0;
+  encoder->NbSamples = 1;
+  encoder->LastDt = 0;
+  encoder->LastXYZ[0] = xyz[0];
+  encoder->LastXYZ[1] = xyz[1];
+  encoder->LastXYZ[2] = xyz[2];
+  buffer[0] = 1;
+  buffer[1] = time & 0xFF;
+  buffer[2] = time >> 8;
+  buffer[3] = xyz[0];
+  buffer[4] = xyz[1];
+  buffer[5] = xyz[2];
+}
+
+
+BOOL Delta_Add(TDeltaEncoder* const encoder, const uint8_t dt, const uint8_t xyz[3])
+{
+  uint8_t axis;
+
+  /*!only take the sample if even its worst case fits*/
+  if (encoder->NbSamples == 0xFF ||
+      DELTA_HEADER_NB_BYTES + (encoder->NbNibbles + DELTA_MAX_SAMPLE_NB_NIBBLES + 1) / 2 > encoder->Size)
+    return bFALSE;
+  PutChange(encoder, dt - encoder->LastDt);
+  encoder->LastDt = dt;
+  for (axis = 0; axis < 3; axis++)
+  {
+    PutChange(encoder, xyz[axis] - encoder->LastXYZ[axis]);
+    encoder->LastXYZ[axis] = xyz[axis];
+  }
+  encoder->Buffer[0] = ++encoder->NbSamples;
+  return bTRUE;
+}
+
+
+uint16_t Delta_NbBytes(const TDeltaEncoder* const encoder)
+{
+  return DELTA_HEADER_NB_BYTES + (encoder->NbNibbles + 1) / 2;
+}
+
+
+uint16_t Delta_Decode(const uint8_t* const data, const uint16_t nbBytes, TDeltaSample* const samples, const uint16_t maxSamples, const uint8_t shift)
+{
+  uint16_t nbSamples, sample, nibble = 0, nbNibbles;
+  uint8_t value, change, dt = 0, i;
+
+  if (nbBytes < DELTA_HEADER_NB_BYTES)
+    return 0;
+  nbSamples = data[0];
+  if (nbSamples == 0 || nbSamples > maxSamples)
+    return 0;
+  nbNibbles = (nbBytes - DELTA_HEADER_NB_BYTES) * 2;
+  samples[0].Time = data[1] | (data[2] << 8);
+  samples[0].XYZ[0] = data[3];
+  samples[0].XYZ[1] = data[4];
+  samples[0].XYZ[2] = data[5];
+  for (sample = 1; sample < nbSamples; sample++)
+  {
+    /*!the time step change, then x, y and z*/
+    for (i = 0; i < 4; i++)
+    {
+      if (nibble >= nbNibbles)
+        return 0;
+      value = GetNibble(data, &nibble);
+      if (value == ESCAPE)
+      {
+        if (nibble + 2 > nbNibbles)
+          return 0;
+        change = GetNibble(data, &nibble) << 4;
+        change |= GetNibble(data, &nibble);
+      }
+      else
+        change = (value & 0x08) ? (value | 0xF0) : value;  /*!sign extend the nibble*/
+      if (i == 0)
+      {
+        dt += change;
+        samples[sample].Time = samples[sample - 1].Time + ((uint16_t)dt << shift);
+      }
+      else
+        samples[sample].XYZ[i - 1] = samples[sample - 1].XYZ[i - 1] + change;
+    }
+  }
+  return nbSamples;
+}
+
+/* END delta */
+/*!
+** @}
+*/
@@ -0,0 +1,90 @@
+/*! @file
+ *
+ *  @brief Routines to delta encode accelerometer samples into nibbles, and to decode them again.
+ *
+ *  Encoded data: the number of samples, the 16-bit time of the first sample (low byte first) and its
+ *  x, y and z bytes as a keyframe; then for every further sample four values, the change in its time
+ *  step and the changes in x, y and z, each as a nibble. A change from -7 to 7 is the nibble itself
+ *  (two's complement), anything else is the escape nibble 0x8 followed by the 8-bit change in two
+ *  nibbles. The nibbles are packed high nibble first, and the last byte is padded with a 0 nibble.
+ *  A sample at rest therefore takes 2 bytes instead of 3, with its time included.
+ *
+ *  @author Liang Wang
+ *  @date 2016-08-05
+ */
+
+#ifndef DELTA_H
+#define DELTA_H
+
+// new types
+#include "types.h"
+
+// Bytes before the nibbles: number of samples, time of the first sample, keyframe
+#define DELTA_HEADER_NB_BYTES 6
+
+// Most nibbles one sample can take: four escaped values
+#define DELTA_MAX_SAMPLE_NB_NIBBLES 12
+
+/*!
+ * @struct TDeltaSample
+ */
+typedef struct
+{
+  uint16_t Time;		/*!< The time of the sample */
+  uint8_t XYZ[3];		/*!< The x, y and z bytes */
+} TDeltaSample;
+
+/*!
+ * @struct TDeltaEncoder
+ */
+typedef struct
+{
+  uint8_t* Buffer;		/*!< The encoded data */
+  uint16_t Size;		/*!< The number of bytes in Buffer */
+  uint16_t NbNibbles;		/*!< The number of nibbles written after the header */
+  uint8_t NbSamples;		/*!< The number of samples encoded */
+  uint8_t LastDt;		/*!< The time step of the last sample */
+  uint8_t LastXYZ[3];		/*!< The x, y and z bytes of the last sample */
+} TDeltaEncoder;
+
+/*! @brief Starts encoding with a keyframe.
+ *
+ *  @param encoder The encoder.
+ *  @param buffer Where the encoded data is written.
+ *  @param size The number of bytes in buffer, at least DELTA_HEADER_NB_BYTES.
+ *  @param time The time of the first sample.
+ *  @param xyz The x, y and z bytes of the first sample.
+ *  @return void
+ */
+void Delta_Start(TDeltaEncoder* const encoder, uint8_t* const buffer, const uint16_t size, const uint16_t time, const uint8_t xyz[3]);
+
+/*! @brief Encodes a further sample.
+ *
+ *  @param encoder The encoder.
+ *  @param dt The time since the sample before.
+ *  @param xyz The x, y and z bytes of the sample.
+ *  @return BOOL - TRUE if the sample was encoded, FALSE if it might not fit or there are 255 samples already.
+ *  @note Assumes that Delta_Start has been called.
+ */
+BOOL Delta_Add(TDeltaEncoder* const encoder, const uint8_t dt, const uint8_t xyz[3]);
+
+/*! @brief Gets the number of bytes of encoded data.
+ *
+ *  @param encoder The encoder.
+ *  @return uint16_t - The number of bytes, including the padding of the last byte.
+ *  @note Assumes that Delta_Start has been called.
+ */
+uint16_t Delta_NbBytes(const TDeltaEncoder* const encoder);
+
+/*! @brief Decodes data written by the encoder.
+ *
+ *  @param data The encoded data.
+ *  @param nbBytes The number of bytes of encoded data.
+ *  @param samples Where the samples are written; times are the first sample's time plus the time steps.
+ *  @param maxSamples The number of samples that fit in samples.
+ *  @param shift The time steps are multiplied by 2^shift.
+ *  @return uint16_t - The number of samples decoded, 0 if the data is malformed or does not fit.
+ */
+uint16_t Delta_Decode(const uint8_t* const data, const uint16_t nbBytes, TDeltaSample* const samples, const uint16_t maxSamples, const uint8_t shift);
+
+#endif
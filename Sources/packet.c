@@ -1,108 +1,663 @@
-/*! @file
- *
- *  @brief packet module: Routines to implement packet encoding and decoding for the serial port.
- *
- *  This module contains the functions for implementing the "Tower to PC Protocol" 5-byte packets.
- *
- *  @author Liang Wang
- *  @date 2016-06-28
- */
-/*!
-**  @addtogroup packet_module packet module documentation
-**  @{
-*/
-/* MODULE packet */
-#include "packet.h"
-
-TPacket Packet;     /*!< Packet as a TPacket*/
-
-/*! @brief Initializes the packets by calling the initialization routines of the supporting software modules.
- *
- *  @param baudRate The desired baud rate in bits/sec.
- *  @param moduleClk The module clock rate in Hz
- *  @return BOOL - TRUE if the packet module was successfully initialized.
- */
-
-BOOL Packet_Init(const uint32_t baudRate, const uint32_t moduleClk)
-{
-   return UART_Init(baudRate, moduleClk);       /*use UART to get the packet*/
-}
-/*! @brief Attempts to get a packet from the received data.
- *
- *  @return BOOL - TRUE if a valid packet was received.
- */
-BOOL Packet_Get(void)
-{
-  static int i = 0;           
-
-  /*!a loop to get a packet*/
-  switch(i)
-  {
-    case 0:
-      if (UART_InChar(&Packet_Command))
-      {
-        i++;
-      }
-      break;
-    case 1:
-      if (UART_InChar(&Packet_Parameter1))
-      {
-        i++;
-      }
-      break;
-    case 2:
-      if (UART_InChar(&Packet_Parameter2))
-      {
-        i++;
-      }
-      break;
-    case 3:
-      if (UART_InChar(&Packet_Parameter3))
-      {
-        i++;
-      }
-      break;
-    case 4:
-      if (UART_InChar(&Packet_Checksum))
-      {
-        i++;
-      }
-      break;
-    /*!check the packet, if not, keep looping*/
-    case 5:
-      if (Packet_Checksum != (Packet_Command^Packet_Parameter1^ Packet_Parameter2^Packet_Parameter3))
-      {
-        Packet_Command = Packet_Parameter1;
-        Packet_Parameter1 = Packet_Parameter2;
-        Packet_Parameter2 = Packet_Parameter3;
-        Packet_Parameter3 = Packet_Checksum;
-        i = 4;
-      }
-      /*!if a packet is got successfully, start another loop*/
-      else
-      {
-        i=0;
-        return bTRUE;
-      }
-      break;
-    default:
-      break;
-  }
-  return bFALSE;
-}
-
-
-BOOL Packet_Put(const uint8_t command, const uint8_t parameter1, const uint8_t parameter2, const uint8_t parameter3)
-{
-  /*!put the packet into TFIFO*/
-  return (UART_OutChar(command) &&
-	  UART_OutChar(parameter1) &&
-	  UART_OutChar(parameter2) &&
-	  UART_OutChar(parameter3) &&
-	  UART_OutChar(command^parameter1^parameter2^parameter3));
-
-}
-/* END packet */
-/*!
-** @}
-*/
+/*! @file
+ *
+ *  @brief packet module: Routines to implement packet encoding and decoding for the serial port.
+ *
+ *  This module contains the functions for implementing the "Tower to PC Protocol" 5-byte packets.
+ *
+ *  @author Liang Wang
+ *  @date 2016-06-28
+ */
+/*!
+**  @addtogroup packet_module packet module documentation
+**  @{
+*/
+/* MODULE packet */
+#include "packet.h"
+#include "CRC.h"
+
+TPacket Packet;     /*!< Packet as a TPacket*/
+
+static uint16_t NbDropped;          /*!< packets Packet_Put could not queue*/
+static uint16_t NbChecksumErrors;   /*!< bad checksums seen by Packet_Get*/
+static uint16_t NbRxDropped;        /*!< received packets the packet queue had no room for*/
+static uint16_t NbOverwritten;      /*!< slot packets replaced before they were sent*/
+
+FIFO_BUFFER(TelemetryBuffer, PACKET_TELEMETRY_FIFO_SIZE);  /*!< storage for TelemetryFIFO*/
+FIFO_DEFINE(TelemetrySizes, uint16_t, PACKET_TELEMETRY_QUEUE_SIZE)  /*!< only used with interrupts disabled, as the callbacks queue telemetry too*/
+
+static TFIFO TelemetryFIFO;             /*!< encoded telemetry packets and frames waiting for room in TxFIFO*/
+static TTelemetrySizes TelemetrySizes;  /*!< the number of bytes of each of them*/
+static uint16_t NextNbBytes;            /*!< size of the oldest one once taken from TelemetrySizes, 0 if not taken yet*/
+static TPacketChecksum ChecksumMode;    /*!< how the last byte of packets and frames is worked out*/
+static uint8_t ExtendedCommand;         /*!< command of the extended telemetry frames, 0 for plain packets*/
+static uint32_t (*Clock)(void);         /*!< gets the time of extended telemetry in microseconds*/
+static uint16_t Sequence;               /*!< sequence number of the next extended telemetry*/
+static BOOL ReceivedTagged;             /*!< whether the packet Packet_Get got last was tagged*/
+static uint8_t ReceivedTag;             /*!< and its tag*/
+static BOOL ReplyTagged;                /*!< whether Packet_Put and Packet_PutFrame tag what they put, with ReceivedTag*/
+
+/*!
+ * @struct TSlot
+ */
+typedef struct
+{
+  uint8_t Bytes[PACKET_EXTENDED_NB_BYTES];  /*!< newest telemetry of the slot, encoded as it is sent*/
+  uint8_t NbBytes;                          /*!< PACKET_NB_BYTES, or PACKET_EXTENDED_NB_BYTES when extended*/
+} TSlot;
+
+static TSlot Slots[PACKET_NB_SLOTS];    /*!< newest telemetry of each slot*/
+static uint8_t SlotsFull;               /*!< bit n is set while Slots[n] has not been sent*/
+
+#if PACKET_ISR_FRAMING
+/*!
+ * @struct TReceived
+ */
+typedef struct
+{
+  TPacket Packet;                   /*!< The packet without its tag */
+  uint8_t Tag;                      /*!< Its tag */
+  BOOL Tagged;                      /*!< Whether it was tagged */
+} TReceived;
+
+FIFO_DEFINE(PacketFIFO, TReceived, PACKET_QUEUE_SIZE)  /*!< PacketFIFO only has the UART receive interrupt as producer and Packet_Get as consumer*/
+
+static TPacketFIFO PacketFIFO;      /*!< received packets waiting for Packet_Get*/
+#endif
+
+/*! @brief Adds a byte to a checksum.
+ *
+ *  @param checksum The checksum of the bytes before, 0 for none.
+ *  @param data The byte.
+ *  @return uint8_t - The checksum including data, their XOR or their CRC-8 depending on ChecksumMode.
+ */
+static uint8_t Check(const uint8_t checksum, const uint8_t data)
+{
+  return (ChecksumMode == PACKET_CHECKSUM_CRC8) ? CRC_UPDATE8(checksum, data) : checksum ^ data;
+}
+
+/*! @brief Gets the index of the byte after one in a window.
+ *
+ */
+#define WINDOW_NEXT(index) (((index) == PACKET_TAGGED_NB_BYTES - 1) ? 0 : (index) + 1)
+
+/*!
+ * @struct TWindow
+ *
+ * The last PACKET_TAGGED_NB_BYTES received bytes, kept in a circular buffer with the XOR of the newest PACKET_NB_BYTES.
+ */
+typedef struct
+{
+  uint8_t Bytes[PACKET_TAGGED_NB_BYTES];  /*!< The received bytes */
+  uint8_t Oldest;                   /*!< The index of the oldest byte */
+  uint8_t NbBytes;                  /*!< The number of bytes in the window */
+  uint8_t Checksum;                 /*!< The XOR of the newest PACKET_NB_BYTES bytes, 0 when they are an XOR packet */
+} TWindow;
+
+/*! @brief Checks the bytes of a window against the newest one with a CRC-8.
+ *
+ *  @param window The window.
+ *  @param first The index of the first byte checked.
+ *  @param nbBytes The number of bytes checked, not counting the newest.
+ *  @param data The newest byte.
+ *  @return BOOL - TRUE if data is the CRC-8 of the bytes.
+ */
+static BOOL CheckCRC(const TWindow* const window, uint8_t first, uint8_t nbBytes, const uint8_t data)
+{
+  uint8_t crc = 0;
+
+  for (; nbBytes; nbBytes--, first = WINDOW_NEXT(first))
+    crc = CRC_UPDATE8(crc, window->Bytes[first]);
+  return crc == data;
+}
+
+/*! @brief Adds a received byte to the window of bytes being framed.
+ *
+ *  A packet's checksum is the XOR of its other four bytes, so the XOR of all five is 0. The window keeps that XOR
+ *  as bytes go in and out, so when a full window is not a packet the oldest byte is dropped and the next byte
+ *  is checked with two XORs rather than by checking the packet again. A CRC-8 cannot be rolled that way,
+ *  so in CRC-8 mode the bytes before the newest are run through the table for each full window.
+ *  The newest byte can end a tagged packet, whose first byte has PACKET_TAG_MASK set and whose checksum
+ *  takes in the byte before the XOR, or a plain one, whose first byte has not. The tagged packet is tried
+ *  first, so that the last five bytes of a tagged packet are never taken for a plain one.
+ *  @param window The window of bytes being framed.
+ *  @param data The received byte.
+ *  @param packet Where the packet is copied when the byte completes one, without its tag.
+ *  @param tag Where the tag is put when the packet is tagged.
+ *  @return uint8_t - PACKET_NB_BYTES or PACKET_TAGGED_NB_BYTES if the byte completed a packet with a valid checksum, else 0.
+ */
+static uint8_t Frame(TWindow* const window, const uint8_t data, TPacket* const packet, uint8_t* const tag)
+{
+  uint8_t index;    /*!< where data goes in the window*/
+  uint8_t first;    /*!< where the packet starts in the window*/
+  uint8_t nbBytes;  /*!< the number of bytes in the packet*/
+  uint8_t i;
+
+  if (window->NbBytes < PACKET_TAGGED_NB_BYTES)
+  {
+    index = window->Oldest + window->NbBytes;
+    if (index >= PACKET_TAGGED_NB_BYTES)
+      index -= PACKET_TAGGED_NB_BYTES;
+    window->NbBytes++;
+  }
+  else
+  {
+    /*!the oldest byte cannot start a packet, it goes out of the window*/
+    index = window->Oldest;
+    window->Oldest = WINDOW_NEXT(index);
+  }
+  /*!the byte five back goes out of the XOR of the newest five*/
+  if (window->NbBytes == PACKET_TAGGED_NB_BYTES)
+    window->Checksum ^= window->Bytes[window->Oldest];
+  window->Bytes[index] = data;
+  window->Checksum ^= data;
+  if (window->NbBytes < PACKET_NB_BYTES)
+    return 0;
+
+  nbBytes = 0;
+  first = window->Oldest;
+  /*!the XOR of the newest five bytes is 0 for a plain packet and the byte before them for a tagged one,
+     which rules out nearly every window of noise with one compare*/
+  if (ChecksumMode == PACKET_CHECKSUM_CRC8 || !window->Checksum ||
+      (window->NbBytes == PACKET_TAGGED_NB_BYTES && window->Checksum == window->Bytes[first]))
+  {
+    if (window->NbBytes == PACKET_TAGGED_NB_BYTES)
+    {
+      if ((window->Bytes[first] & PACKET_TAG_MASK) &&
+          ((ChecksumMode == PACKET_CHECKSUM_CRC8) ? CheckCRC(window, first, PACKET_TAGGED_NB_BYTES - 1, data) : window->Checksum == window->Bytes[first]))
+        nbBytes = PACKET_TAGGED_NB_BYTES;
+      else
+        first = WINDOW_NEXT(first);
+    }
+    if (!nbBytes && !(window->Bytes[first] & PACKET_TAG_MASK) &&
+        ((ChecksumMode == PACKET_CHECKSUM_CRC8) ? CheckCRC(window, first, PACKET_NB_BYTES - 1, data) : !window->Checksum))
+      nbBytes = PACKET_NB_BYTES;
+  }
+  if (!nbBytes)
+  {
+    /*!five bytes may yet be the start of a tagged packet, only a full window slides along*/
+    if (window->NbBytes == PACKET_TAGGED_NB_BYTES)
+      NbChecksumErrors++;
+    return 0;
+  }
+  /*!a packet, copy it out in order without its tag and start another one*/
+  packet->Bytes[0] = window->Bytes[first] & ~PACKET_TAG_MASK;
+  first = WINDOW_NEXT(first);
+  if (nbBytes == PACKET_TAGGED_NB_BYTES)
+  {
+    *tag = window->Bytes[first];
+    first = WINDOW_NEXT(first);
+  }
+  for (i = 1; i < PACKET_NB_BYTES; i++, first = WINDOW_NEXT(first))
+    packet->Bytes[i] = window->Bytes[first];
+  window->Oldest = 0;
+  window->NbBytes = 0;
+  window->Checksum = 0;
+  return nbBytes;
+}
+
+#if PACKET_ISR_FRAMING
+/*! @brief Frames a received byte and queues the packet it completes.
+ *
+ *  @param data The received byte.
+ *  @note Called from the UART interrupt, it has a packet of its own so that Packet is only used by the foreground.
+ */
+static void ReceiveByte(const uint8_t data)
+{
+  static TWindow window;          /*!< bytes being framed*/
+  TReceived received;
+  uint8_t nbBytes;
+
+  nbBytes = Frame(&window, data, &received.Packet, &received.Tag);
+  if (!nbBytes)
+    return;
+  received.Tagged = (nbBytes == PACKET_TAGGED_NB_BYTES);
+  if (!PacketFIFO_Put(&PacketFIFO, &received))
+    NbRxDropped++;
+}
+#endif
+
+/*! @brief Encodes a packet into reserved room.
+ *
+ *  @param span The PACKET_NB_BYTES reserved bytes, PACKET_TAGGED_NB_BYTES if tagged.
+ *  @param tagged Whether the packet is tagged with ReceivedTag.
+ */
+static void EncodePacket(const TFIFOSpan* const span, const BOOL tagged, const uint8_t command, const uint8_t parameter1, const uint8_t parameter2, const uint8_t parameter3)
+{
+  uint8_t checksum;
+  uint8_t i = 0;    /*!< where the parameters go, after the tag if there is one*/
+
+  if (tagged)
+  {
+    *FIFO_SPAN_AT(span, 0) = command | PACKET_TAG_MASK;
+    *FIFO_SPAN_AT(span, 1) = ReceivedTag;
+    checksum = Check(Check(0, command | PACKET_TAG_MASK), ReceivedTag);
+    i = 1;
+  }
+  else
+  {
+    *FIFO_SPAN_AT(span, 0) = command;
+    checksum = Check(0, command);
+  }
+  *FIFO_SPAN_AT(span, i + 1) = parameter1;
+  *FIFO_SPAN_AT(span, i + 2) = parameter2;
+  *FIFO_SPAN_AT(span, i + 3) = parameter3;
+  *FIFO_SPAN_AT(span, i + 4) = Check(Check(Check(checksum, parameter1), parameter2), parameter3);
+}
+
+/*! @brief Encodes a variable length frame into reserved room.
+ *
+ *  @param span The nbBytes + PACKET_FRAME_OVERHEAD reserved bytes, one more if tagged.
+ *  @param tagged Whether the frame is tagged with ReceivedTag.
+ */
+static void EncodeFrame(const TFIFOSpan* const span, const BOOL tagged, const uint8_t command, const uint8_t* const data, const uint8_t nbBytes)
+{
+  uint8_t checksum;
+  uint16_t i;
+  uint16_t j = 1;   /*!< where the length goes, after the tag if there is one*/
+
+  if (tagged)
+  {
+    *FIFO_SPAN_AT(span, 0) = command | PACKET_TAG_MASK;
+    *FIFO_SPAN_AT(span, 1) = ReceivedTag;
+    checksum = Check(Check(0, command | PACKET_TAG_MASK), ReceivedTag);
+    j = 2;
+  }
+  else
+  {
+    *FIFO_SPAN_AT(span, 0) = command;
+    checksum = Check(0, command);
+  }
+  *FIFO_SPAN_AT(span, j) = nbBytes;
+  checksum = Check(checksum, nbBytes);
+  for (i = 0; i < nbBytes; i++)
+  {
+    *FIFO_SPAN_AT(span, j + 1 + i) = data[i];
+    checksum = Check(checksum, data[i]);
+  }
+  *FIFO_SPAN_AT(span, j + 1 + nbBytes) = checksum;
+}
+
+/*! @brief Encodes a telemetry packet, as an extended frame with the next sequence number and the time when those are on.
+ *
+ *  @param bytes Where the telemetry is encoded, room for PACKET_EXTENDED_NB_BYTES.
+ *  @return uint8_t - The number of bytes encoded.
+ *  @note Must be called with interrupts disabled.
+ */
+static uint8_t EncodeTelemetry(uint8_t* const bytes, const uint8_t command, const uint8_t parameter1, const uint8_t parameter2, const uint8_t parameter3)
+{
+  uint32_t time;
+  uint8_t i;
+
+  if (!ExtendedCommand)
+  {
+    bytes[0] = command;
+    bytes[1] = parameter1;
+    bytes[2] = parameter2;
+    bytes[3] = parameter3;
+    bytes[4] = Check(Check(Check(Check(0, command), parameter1), parameter2), parameter3);
+    return PACKET_NB_BYTES;
+  }
+  time = Clock();
+  bytes[0] = ExtendedCommand;
+  bytes[1] = PACKET_EXTENDED_NB_DATA;
+  bytes[2] = Sequence & 0xFF;
+  bytes[3] = Sequence >> 8;
+  bytes[4] = time & 0xFF;
+  bytes[5] = (time >> 8) & 0xFF;
+  bytes[6] = (time >> 16) & 0xFF;
+  bytes[7] = time >> 24;
+  bytes[8] = command;
+  bytes[9] = parameter1;
+  bytes[10] = parameter2;
+  bytes[11] = parameter3;
+  bytes[12] = 0;
+  for (i = 0; i < PACKET_EXTENDED_NB_BYTES - 1; i++)
+    bytes[12] = Check(bytes[12], bytes[i]);
+  Sequence++;
+  return PACKET_EXTENDED_NB_BYTES;
+}
+
+/*! @brief Reserves room in TxFIFO for telemetry, if TxFIFO is below PACKET_TELEMETRY_TX_LIMIT.
+ *
+ *  An empty TxFIFO always has room, however big the telemetry is.
+ *  @param nbBytes The number of bytes to reserve.
+ *  @param span A pointer to a span that is set to the reserved part of TxFIFO.
+ *  @return BOOL - TRUE if the room was reserved.
+ */
+static BOOL TxReserve(const uint16_t nbBytes, TFIFOSpan* const span)
+{
+  uint16_t nbQueued = UART_OutNbBytes();    /*!< bytes already waiting in TxFIFO*/
+
+  if (nbQueued && nbQueued + nbBytes > PACKET_TELEMETRY_TX_LIMIT)
+    return bFALSE;
+  return UART_OutReserve(nbBytes, span);
+}
+
+/*! @brief Moves the slot packets, then whole telemetry packets and frames, into TxFIFO while it has room for them.
+ *
+ *  @note Called from the UART transmit interrupt and after telemetry is queued.
+ */
+static void SendTelemetry(void)
+{
+  TFIFOSpan span;       /*!< the part of TxFIFO the telemetry is copied into*/
+  uint8_t slot;
+  uint8_t i;
+
+  EnterCritical();
+  /*!a slot only ever holds its newest packet, so the slots go first*/
+  for (slot = 0; SlotsFull && slot < PACKET_NB_SLOTS; slot++)
+  {
+    if (!(SlotsFull & (1 << slot)))
+      continue;
+    if (!TxReserve(Slots[slot].NbBytes, &span))
+    {
+      ExitCritical();
+      return;
+    }
+    for (i = 0; i < Slots[slot].NbBytes; i++)
+      *FIFO_SPAN_AT(&span, i) = Slots[slot].Bytes[i];
+    UART_OutCommit(Slots[slot].NbBytes);
+    SlotsFull &= ~(1 << slot);
+  }
+  while (NextNbBytes || TelemetrySizes_Get(&TelemetrySizes, &NextNbBytes))
+  {
+    if (!TxReserve(NextNbBytes, &span))
+      break;
+    (void)FIFO_GetBlock(&TelemetryFIFO, span.Data1, span.Size1);
+    (void)FIFO_GetBlock(&TelemetryFIFO, span.Data2, span.Size2);
+    UART_OutCommit(NextNbBytes);
+    NextNbBytes = 0;
+  }
+  ExitCritical();
+}
+
+/*! @brief Reserves room in the telemetry queue.
+ *
+ *  @param nbBytes The number of bytes to reserve.
+ *  @param span A pointer to a span that is set to the reserved part of TelemetryFIFO.
+ *  @return BOOL - TRUE if the room was reserved.
+ *  @note Must be called with interrupts disabled, and followed by TelemetryCommit.
+ */
+static BOOL TelemetryReserve(const uint16_t nbBytes, TFIFOSpan* const span)
+{
+  if (TelemetrySizes_NbItems(&TelemetrySizes) == PACKET_TELEMETRY_QUEUE_SIZE || !FIFO_Reserve(&TelemetryFIFO, nbBytes, span))
+  {
+    NbDropped++;
+    return bFALSE;
+  }
+  return bTRUE;
+}
+
+/*! @brief Queues the telemetry encoded into a reservation, and sends it straight away if TxFIFO has room.
+ *
+ *  @param nbBytes The number of bytes reserved.
+ *  @note Must be called with interrupts disabled.
+ */
+static void TelemetryCommit(const uint16_t nbBytes)
+{
+  FIFO_Commit(&TelemetryFIFO, nbBytes);
+  (void)TelemetrySizes_Put(&TelemetrySizes, &nbBytes);
+  SendTelemetry();
+}
+
+/*! @brief Works out again the last byte of the slot packets and of the telemetry still in the telemetry queue.
+ *
+ *  Packets, frames and extended frames all end in the checksum of every byte before it, so it can be
+ *  redone in place without knowing which each one is.
+ *  @note Must be called with interrupts disabled.
+ */
+static void RecheckTelemetry(void)
+{
+  uint16_t index = TelemetryFIFO.Start;     /*!< where the next one starts in TelemetryBuffer*/
+  uint16_t item = TelemetrySizes.Tail;      /*!< the next entry of TelemetrySizes*/
+  uint16_t nbBytes = NextNbBytes;           /*!< the size of the oldest one, if already taken from TelemetrySizes*/
+  uint16_t i;
+  uint8_t checksum;
+  uint8_t slot;
+
+  for (slot = 0; slot < PACKET_NB_SLOTS; slot++)
+  {
+    if (!(SlotsFull & (1 << slot)))
+      continue;
+    checksum = 0;
+    for (i = 0; i < Slots[slot].NbBytes - 1; i++)
+      checksum = Check(checksum, Slots[slot].Bytes[i]);
+    Slots[slot].Bytes[i] = checksum;
+  }
+  for (;;)
+  {
+    if (!nbBytes)
+    {
+      if (item == TelemetrySizes.Head)
+        break;
+      nbBytes = TelemetrySizes.Buffer[item++ & (PACKET_TELEMETRY_QUEUE_SIZE - 1)];
+    }
+    checksum = 0;
+    for (i = 0; i < nbBytes - 1; i++)
+      checksum = Check(checksum, TelemetryFIFO.Buffer[(index + i) & TelemetryFIFO.Mask]);
+    TelemetryFIFO.Buffer[(index + i) & TelemetryFIFO.Mask] = checksum;
+    index += nbBytes;
+    nbBytes = 0;
+  }
+}
+
+/*! @brief Initializes the packets by calling the initialization routines of the supporting software modules.
+ *
+ *  @param baudRate The desired baud rate in bits/sec.
+ *  @param moduleClk The module clock rate in Hz
+ *  @return BOOL - TRUE if the packet module was successfully initialized.
+ */
+
+BOOL Packet_Init(const uint32_t baudRate, const uint32_t moduleClk)
+{
+  FIFO_Init(&TelemetryFIFO, TelemetryBuffer, sizeof(TelemetryBuffer));
+  TelemetrySizes_Init(&TelemetrySizes);
+  NextNbBytes = 0;
+  SlotsFull = 0;
+  ChecksumMode = PACKET_CHECKSUM_XOR;
+  ExtendedCommand = 0;
+  Sequence = 0;
+  ReceivedTagged = bFALSE;
+  ReplyTagged = bFALSE;
+#if PACKET_ISR_FRAMING
+  PacketFIFO_Init(&PacketFIFO);
+#endif
+  if (!UART_Init(baudRate, moduleClk))          /*use UART to get the packet*/
+    return bFALSE;
+#if PACKET_ISR_FRAMING
+  UART_SetRxCallback(ReceiveByte);              /*the UART interrupt frames the packets*/
+#endif
+  UART_SetTxCallback(SendTelemetry);            /*telemetry fills in behind the replies as the transmitter empties*/
+  return bTRUE;
+}
+
+/*! @brief Attempts to get a packet from the received data.
+ *
+ *  @return BOOL - TRUE if a valid packet was received.
+ */
+BOOL Packet_Get(void)
+{
+#if PACKET_ISR_FRAMING
+  TReceived received;
+
+  /*!the packets are already framed and checked, take the oldest whole*/
+  if (!PacketFIFO_Get(&PacketFIFO, &received))
+    return bFALSE;
+  Packet = received.Packet;
+  ReceivedTag = received.Tag;
+  ReceivedTagged = received.Tagged;
+  return bTRUE;
+#else
+  static TWindow window;          /*!< bytes being framed, Packet is only written once they are a packet*/
+  uint8_t data;
+  uint8_t nbBytes;
+
+  /*!take every byte that has arrived until a packet is complete, not just one byte per call*/
+  while (UART_InChar(&data))
+  {
+    nbBytes = Frame(&window, data, &Packet, &ReceivedTag);
+    if (nbBytes)
+    {
+      ReceivedTagged = (nbBytes == PACKET_TAGGED_NB_BYTES);
+      return bTRUE;
+    }
+  }
+  return bFALSE;
+#endif
+}
+
+
+BOOL Packet_GetTag(uint8_t* const tag)
+{
+  if (ReceivedTagged)
+    *tag = ReceivedTag;
+  return ReceivedTagged;
+}
+
+
+void Packet_TagReplies(const BOOL on)
+{
+  ReplyTagged = on && ReceivedTagged;
+}
+
+
+BOOL Packet_Put(const uint8_t command, const uint8_t parameter1, const uint8_t parameter2, const uint8_t parameter3)
+{
+  TFIFOSpan span;     /*!< the part of TxFIFO the packet is encoded into*/
+  uint8_t nbBytes = ReplyTagged ? PACKET_TAGGED_NB_BYTES : PACKET_NB_BYTES;
+
+  /*!the callbacks send packets from interrupts too, so keep them out until the packet is committed*/
+  EnterCritical();
+  if (!UART_OutReserve(nbBytes, &span))
+  {
+    NbDropped++;
+    ExitCritical();
+    return bFALSE;
+  }
+  /*!encode the packet straight into TxFIFO, it is only sent once all of it is there*/
+  EncodePacket(&span, ReplyTagged, command, parameter1, parameter2, parameter3);
+  UART_OutCommit(nbBytes);
+  ExitCritical();
+  return bTRUE;
+}
+
+
+BOOL Packet_PutFrame(const uint8_t command, const uint8_t* const data, const uint8_t nbBytes)
+{
+  TFIFOSpan span;     /*!< the part of TxFIFO the frame is encoded into*/
+  uint16_t size = nbBytes + PACKET_FRAME_OVERHEAD + (ReplyTagged ? 1 : 0);
+
+  EnterCritical();
+  if (!UART_OutReserve(size, &span))
+  {
+    NbDropped++;
+    ExitCritical();
+    return bFALSE;
+  }
+  EncodeFrame(&span, ReplyTagged, command, data, nbBytes);
+  UART_OutCommit(size);
+  ExitCritical();
+  return bTRUE;
+}
+
+
+BOOL Packet_PutTelemetry(const uint8_t command, const uint8_t parameter1, const uint8_t parameter2, const uint8_t parameter3)
+{
+  TFIFOSpan span;     /*!< the part of TelemetryFIFO the packet is copied into*/
+  uint8_t bytes[PACKET_EXTENDED_NB_BYTES];
+  uint8_t nbBytes;
+  uint8_t i;
+
+  EnterCritical();
+  nbBytes = EncodeTelemetry(bytes, command, parameter1, parameter2, parameter3);
+  if (!TelemetryReserve(nbBytes, &span))
+  {
+    ExitCritical();
+    return bFALSE;
+  }
+  for (i = 0; i < nbBytes; i++)
+    *FIFO_SPAN_AT(&span, i) = bytes[i];
+  TelemetryCommit(nbBytes);
+  ExitCritical();
+  return bTRUE;
+}
+
+
+BOOL Packet_PutTelemetryFrame(const uint8_t command, const uint8_t* const data, const uint8_t nbBytes)
+{
+  TFIFOSpan span;     /*!< the part of TelemetryFIFO the frame is encoded into*/
+
+  EnterCritical();
+  if (!TelemetryReserve(nbBytes + PACKET_FRAME_OVERHEAD, &span))
+  {
+    ExitCritical();
+    return bFALSE;
+  }
+  EncodeFrame(&span, bFALSE, command, data, nbBytes);
+  TelemetryCommit(nbBytes + PACKET_FRAME_OVERHEAD);
+  ExitCritical();
+  return bTRUE;
+}
+
+
+BOOL Packet_PutLatest(const uint8_t slot, const uint8_t command, const uint8_t parameter1, const uint8_t parameter2, const uint8_t parameter3)
+{
+  if (slot >= PACKET_NB_SLOTS)
+    return bFALSE;
+  EnterCritical();
+  /*!an unsent packet is stale now, the new one takes its place*/
+  if (SlotsFull & (1 << slot))
+    NbOverwritten++;
+  Slots[slot].NbBytes = EncodeTelemetry(Slots[slot].Bytes, command, parameter1, parameter2, parameter3);
+  SlotsFull |= 1 << slot;
+  SendTelemetry();
+  ExitCritical();
+  return bTRUE;
+}
+
+
+void Packet_SetChecksum(const TPacketChecksum checksum)
+{
+  EnterCritical();
+  ChecksumMode = checksum;
+  /*!telemetry put before the change but sent after it has to be checked the new way too*/
+  RecheckTelemetry();
+  ExitCritical();
+}
+
+
+void Packet_SetExtended(const uint8_t command, uint32_t (*clock)(void))
+{
+  EnterCritical();
+  Clock = clock;
+  ExtendedCommand = clock ? command : 0;
+  ExitCritical();
+}
+
+
+uint16_t Packet_NbDropped(void)
+{
+  return NbDropped;
+}
+
+
+uint16_t Packet_NbOverwritten(void)
+{
+  return NbOverwritten;
+}
+
+
+uint16_t Packet_NbRxDropped(void)
+{
+  return NbRxDropped;
+}
+
+
+uint16_t Packet_NbChecksumErrors(void)
+{
+  return NbChecksumErrors;
+}
+/* END packet */
+/*!
+** @}
+*/
@@ -1,87 +1,244 @@
-/*! @file
- *
- *  @brief Routines to implement packet encoding and decoding for the serial port.
- *
- *  This contains the functions for implementing the "Tower to PC Protocol" 5-byte packets.
- *
- *  @author PMcL
- *  @date 2015-07-23
- */
-
-#ifndef PACKET_H
-#define PACKET_H
-
-// New types
-#include "types.h"
-#include "UART.h"
-// Packet structure
-#define PACKET_NB_BYTES 5
-
-#pragma pack(push)
-#pragma pack(1)
-
-typedef union
-{
-  uint8_t Bytes[PACKET_NB_BYTES];     /*!< The packet as an array of bytes. */
-  struct
-  {
-    uint8_t command;		      /*!< The packet's command. */
-    union
-    {
-      struct
-      {
-        uint8_t parameter1;	      /*!< The packet's 1st parameter. */
-        uint8_t parameter2;	      /*!< The packet's 2nd parameter. */
-        uint8_t parameter3;	      /*!< The packet's 3rd parameter. */
-      } separate;
-      struct
-      {
-        uint16_t parameter12;         /*!< Parameter 1 and 2 concatenated. */
-        uint8_t parameter3;
-      } combined12;
-      struct
-      {
-        uint8_t paramater1;
-        uint16_t parameter23;         /*!< Parameter 2 and 3 concatenated. */
-      } combined23;
-    } parameters;
-    uint8_t checksum;
-  } packetStruct;
-} TPacket;
-
-#pragma pack(pop)
-
-#define Packet_Command     Packet.packetStruct.command
-#define Packet_Parameter1  Packet.packetStruct.parameters.separate.parameter1
-#define Packet_Parameter2  Packet.packetStruct.parameters.separate.parameter2
-#define Packet_Parameter3  Packet.packetStruct.parameters.separate.parameter3
-#define Packet_Parameter12 Packet.packetStruct.parameters.combined12.parameter12
-#define Packet_Parameter23 Packet.packetStruct.parameters.combined23.parameter23
-#define Packet_Checksum    Packet.packetStruct.checksum
-
-extern TPacket Packet;
-
-// Acknowledgment bit mask
-extern const uint8_t PACKET_ACK_MASK;
-
-/*! @brief Initializes the packets by calling the initialization routines of the supporting software modules.
- *
- *  @param baudRate The desired baud rate in bits/sec.
- *  @param moduleClk The module clock rate in Hz.
- *  @return BOOL - TRUE if the packet module was successfully initialized.
- */
-BOOL Packet_Init(const uint32_t baudRate, const uint32_t moduleClk);
-
-/*! @brief Attempts to get a packet from the received data.
- *
- *  @return BOOL - TRUE if a valid packet was received.
- */
-BOOL Packet_Get(void);
-
-/*! @brief Builds a packet and places it in the transmit FIFO buffer.
- *
- *  @return BOOL - TRUE if a valid packet was sent.
- */
-BOOL Packet_Put(const uint8_t command, const uint8_t parameter1, const uint8_t parameter2, const uint8_t parameter3);
-
-#endif
+/*! @file
+ *
+ *  @brief Routines to implement packet encoding and decoding for the serial port.
+ *
+ *  This contains the functions for implementing the "Tower to PC Protocol" 5-byte packets.
+ *
+ *  @author PMcL
+ *  @date 2015-07-23
+ */
+
+#ifndef PACKET_H
+#define PACKET_H
+
+// New types
+#include "types.h"
+#include "UART.h"
+// Packet structure
+#define PACKET_NB_BYTES 5
+
+// Set to 1 to frame packets in the UART receive interrupt, only packets with a valid checksum
+// are queued for Packet_Get, PACKET_QUEUE_SIZE of them (a power of two)
+#ifndef PACKET_ISR_FRAMING
+#define PACKET_ISR_FRAMING 0
+#endif
+#define PACKET_QUEUE_SIZE 8
+
+// Variable length frames: command, number of data bytes, the data bytes, then the checksum of all of them,
+// their XOR or their CRC-8 as set with Packet_SetChecksum
+#define PACKET_FRAME_OVERHEAD 3
+#define PACKET_FRAME_MAX_DATA 255
+
+// Telemetry (streamed data nobody asked for) waits in a queue of its own, so that it cannot hold up command replies:
+// it is moved into the transmit FIFO only while that holds fewer than PACKET_TELEMETRY_TX_LIMIT bytes, which bounds
+// how long a reply waits behind it. The queue holds PACKET_TELEMETRY_FIFO_SIZE bytes in at most
+// PACKET_TELEMETRY_QUEUE_SIZE packets and frames, both powers of two
+#define PACKET_TELEMETRY_TX_LIMIT 64
+#define PACKET_TELEMETRY_FIFO_SIZE 1024
+#define PACKET_TELEMETRY_QUEUE_SIZE 64
+
+// Telemetry of which only the newest value matters is put in a slot instead, where it replaces
+// the packet still waiting there; the slots are sent before the telemetry queue
+#define PACKET_NB_SLOTS 4
+
+// Extended telemetry: with Packet_SetExtended, every telemetry packet goes out as a frame whose data is a rolling
+// 16-bit sequence number, the 32-bit time in microseconds it was put (both low byte first), then the packet
+// without its checksum, so the PC can tell lost, reordered and late packets apart
+#define PACKET_EXTENDED_NB_DATA 10
+#define PACKET_EXTENDED_NB_BYTES (PACKET_EXTENDED_NB_DATA + PACKET_FRAME_OVERHEAD)
+
+// Tagged packets: a packet whose command has PACKET_TAG_MASK set has a tag byte after the command, then the
+// parameters and checksum as usual. Every reply to a tagged request, the acknowledgement included, is tagged
+// with the same tag (frames put the tag before the length), so the PC can keep several requests in flight and
+// match each reply to its request
+#define PACKET_TAG_MASK 0x40
+#define PACKET_TAGGED_NB_BYTES (PACKET_NB_BYTES + 1)
+
+// How the last byte of packets and frames is worked out from the bytes before it
+typedef enum
+{
+  PACKET_CHECKSUM_XOR,        /*!< their XOR, the default */
+  PACKET_CHECKSUM_CRC8        /*!< their CRC-8, see CRC.h */
+} TPacketChecksum;
+
+#pragma pack(push)
+#pragma pack(1)
+
+typedef union
+{
+  uint8_t Bytes[PACKET_NB_BYTES];     /*!< The packet as an array of bytes. */
+  struct
+  {
+    uint8_t command;		      /*!< The packet's command. */
+    union
+    {
+      struct
+      {
+        uint8_t parameter1;	      /*!< The packet's 1st parameter. */
+        uint8_t parameter2;	      /*!< The packet's 2nd parameter. */
+        uint8_t parameter3;	      /*!< The packet's 3rd parameter. */
+      } separate;
+      struct
+      {
+        uint16_t parameter12;         /*!< Parameter 1 and 2 concatenated. */
+        uint8_t parameter3;
+      } combined12;
+      struct
+      {
+        uint8_t paramater1;
+        uint16_t parameter23;         /*!< Parameter 2 and 3 concatenated. */
+      } combined23;
+    } parameters;
+    uint8_t checksum;
+  } packetStruct;
+} TPacket;
+
+#pragma pack(pop)
+
+#define Packet_Command     Packet.packetStruct.command
+#define Packet_Parameter1  Packet.packetStruct.parameters.separate.parameter1
+#define Packet_Parameter2  Packet.packetStruct.parameters.separate.parameter2
+#define Packet_Parameter3  Packet.packetStruct.parameters.separate.parameter3
+#define Packet_Parameter12 Packet.packetStruct.parameters.combined12.parameter12
+#define Packet_Parameter23 Packet.packetStruct.parameters.combined23.parameter23
+#define Packet_Checksum    Packet.packetStruct.checksum
+
+// Fields of a packet passed by pointer
+#define PACKET_COMMAND(packet)     ((packet)->packetStruct.command)
+#define PACKET_PARAMETER1(packet)  ((packet)->packetStruct.parameters.separate.parameter1)
+#define PACKET_PARAMETER2(packet)  ((packet)->packetStruct.parameters.separate.parameter2)
+#define PACKET_PARAMETER3(packet)  ((packet)->packetStruct.parameters.separate.parameter3)
+#define PACKET_PARAMETER12(packet) ((packet)->packetStruct.parameters.combined12.parameter12)
+#define PACKET_PARAMETER23(packet) ((packet)->packetStruct.parameters.combined23.parameter23)
+#define PACKET_CHECKSUM(packet)    ((packet)->packetStruct.checksum)
+
+extern TPacket Packet;
+
+// Acknowledgment bit mask
+extern const uint8_t PACKET_ACK_MASK;
+
+/*! @brief Initializes the packets by calling the initialization routines of the supporting software modules.
+ *
+ *  @param baudRate The desired baud rate in bits/sec.
+ *  @param moduleClk The module clock rate in Hz.
+ *  @return BOOL - TRUE if the packet module was successfully initialized.
+ */
+BOOL Packet_Init(const uint32_t baudRate, const uint32_t moduleClk);
+
+/*! @brief Attempts to get a packet from the received data.
+ *
+ *  Takes received bytes until a packet is complete or there are none left, so calling it until it
+ *  returns FALSE handles every packet that has arrived. A tagged packet is put in Packet without its tag
+ *  and without PACKET_TAG_MASK in its command, Packet_GetTag gets the tag.
+ *  @return BOOL - TRUE if a valid packet was received, it is in Packet.
+ */
+BOOL Packet_Get(void);
+
+/*! @brief Gets the tag of the packet Packet_Get got last.
+ *
+ *  @param tag A pointer to where the tag is put if the packet was tagged.
+ *  @return BOOL - TRUE if the packet was tagged.
+ */
+BOOL Packet_GetTag(uint8_t* const tag);
+
+/*! @brief Starts or stops tagging the replies to the packet Packet_Get got last.
+ *
+ *  While on, and if that packet was tagged, Packet_Put and Packet_PutFrame send tagged packets and frames
+ *  with its tag. Telemetry is never tagged.
+ *  @param on TRUE before the packet is handled, FALSE once its replies have been put.
+ *  @return void
+ *  @note Packet_Put and Packet_PutFrame are only called from the foreground, so they can be tagged this way.
+ */
+void Packet_TagReplies(const BOOL on);
+
+/*! @brief Builds a packet and places it in the transmit FIFO buffer, ahead of any queued telemetry.
+ *
+ *  For command replies and anything else the PC waits for.
+ *  @return BOOL - TRUE if a valid packet was sent.
+ */
+BOOL Packet_Put(const uint8_t command, const uint8_t parameter1, const uint8_t parameter2, const uint8_t parameter3);
+
+/*! @brief Builds a variable length frame and places it in the transmit FIFO buffer.
+ *
+ *  The frame is the command, the number of data bytes, the data bytes, and their checksum, see Packet_SetChecksum.
+ *  It is queued whole or not at all. A tagged frame has the tag between the command and the number of data bytes.
+ *  @param command The frame's command, which the PC knows to be followed by a length.
+ *  @param data The data bytes.
+ *  @param nbBytes The number of data bytes, at most PACKET_FRAME_MAX_DATA.
+ *  @return BOOL - TRUE if the frame was queued.
+ */
+BOOL Packet_PutFrame(const uint8_t command, const uint8_t* const data, const uint8_t nbBytes);
+
+/*! @brief Builds a packet and places it in the telemetry queue, to be sent when the transmit FIFO runs low.
+ *
+ *  For data sent on a schedule, e.g. the time and accelerometer readings.
+ *  @return BOOL - TRUE if the packet was queued.
+ */
+BOOL Packet_PutTelemetry(const uint8_t command, const uint8_t parameter1, const uint8_t parameter2, const uint8_t parameter3);
+
+/*! @brief Builds a variable length frame and places it in the telemetry queue, to be sent when the transmit FIFO runs low.
+ *
+ *  @param command The frame's command.
+ *  @param data The data bytes.
+ *  @param nbBytes The number of data bytes, at most PACKET_FRAME_MAX_DATA.
+ *  @return BOOL - TRUE if the frame was queued.
+ */
+BOOL Packet_PutTelemetryFrame(const uint8_t command, const uint8_t* const data, const uint8_t nbBytes);
+
+/*! @brief Builds a packet and places it in a telemetry slot, replacing the packet there if it has not been sent yet.
+ *
+ *  For readings that are stale once a newer one exists, e.g. the time and the accelerometer, so that
+ *  the PC gets the newest reading when the link cannot keep up rather than a backlog of old ones.
+ *  @param slot The slot, 0 to PACKET_NB_SLOTS - 1, one for each kind of reading.
+ *  @return BOOL - TRUE if the packet was placed in the slot, FALSE if there is no such slot.
+ */
+BOOL Packet_PutLatest(const uint8_t slot, const uint8_t command, const uint8_t parameter1, const uint8_t parameter2, const uint8_t parameter3);
+
+/*! @brief Changes how the checksum of packets and frames is worked out, in both directions.
+ *
+ *  Takes effect for the packets put and the bytes framed from then on. Telemetry waiting in a slot or in the
+ *  telemetry queue is checked again the new way, as it goes out after the change. What is already in the
+ *  transmit FIFO keeps its old checksum: that is the reply to the change, its acknowledgement, and any
+ *  telemetry the transmit interrupt moved in before the call, so the PC should switch once it has the
+ *  acknowledgement and may see a bad packet from that telemetry.
+ *  Packets already framed by the UART interrupt (PACKET_ISR_FRAMING) were checked the old way, which is
+ *  right, as the PC sent them before it had the reply.
+ *  @param checksum PACKET_CHECKSUM_XOR or PACKET_CHECKSUM_CRC8.
+ *  @return void
+ */
+void Packet_SetChecksum(const TPacketChecksum checksum);
+
+/*! @brief Turns extended telemetry on or off.
+ *
+ *  Applies to the packets put with Packet_PutTelemetry and Packet_PutLatest from then on, not to telemetry frames.
+ *  @param command The command of the extended frames, 0 to send plain packets again.
+ *  @param clock A function that gets the time in microseconds, used while command is not 0.
+ *  @return void
+ */
+void Packet_SetExtended(const uint8_t command, uint32_t (*clock)(void));
+
+/*! @brief Gets the number of packets and frames that could not be queued.
+ *
+ *  @return uint16_t - The number of packets and frames dropped, telemetry included, wraps around at 65536.
+ */
+uint16_t Packet_NbDropped(void);
+
+/*! @brief Gets the number of slot packets replaced by a newer one before they were sent.
+ *
+ *  @return uint16_t - The number of packets replaced, wraps around at 65536.
+ */
+uint16_t Packet_NbOverwritten(void);
+
+/*! @brief Gets the number of received packets lost because the packet queue was full.
+ *
+ *  @return uint16_t - The number of packets lost, always 0 unless PACKET_ISR_FRAMING is set.
+ */
+uint16_t Packet_NbRxDropped(void);
+
+/*! @brief Gets the number of times Packet_Get found a bad checksum and slid along by a byte.
+ *
+ *  @return uint16_t - The number of checksum errors, wraps around at 65536.
+ */
+uint16_t Packet_NbChecksumErrors(void);
+
+#endif
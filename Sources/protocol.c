@@ -0,0 +1,379 @@
+/*! @file
+ *
+ *  @brief protocol module: Routines to receive packets and carry out the commands that only need the serial stack.
+ *
+ *  This module contains the packet loop and the handlers shared by the tower and the virtual tower.
+ *
+ *  @author Liang Wang
+ *  @date 2016-08-16
+ */
+/*!
+**  @addtogroup protocol_module protocol module documentation
+**  @{
+*/
+/* MODULE protocol */
+#include "protocol.h"
+#include "packet.h"
+#include "command.h"
+#include "Flash.h"
+#include "UART.h"
+
+#define CR 0x0d                                       /*!<0x0d is CR*/
+#define MAJOR_VERSION_NUMBER 0x01                     /*!<0x01 is MAJOR_VERSION_NUMBER*/
+#define MINOR_VERSION_NUMBER 0x00                     /*!<0x00 is MINOR_VERSION_NUMBER*/
+#define GET_TOWER_NUMBER 0x01                         /*!<0x01 is  GET_TOWER_NUMBER*/
+#define SET_TOWER_NUMBER 0x02                         /*!<0x02 is SET_TOWER_NUMBER*/
+#define STUDENT_NUMBER 6928                           /*!<6928 is STUDENT_NUMBER*/
+#define UNPROGRAMED_NUMBER 0xFFFF                     /*!<0xFFFF is UNPROGRAMED_NUMBER*/
+#define TOWER_INIT_MODE 0x01                          /*!<0x01 is TOWER_INIT_MODE*/
+#define MAX_BAUDRATE_ERROR 3                          /*!<largest baud rate error in percent a new baud rate may have*/
+#define COMMANDSTATS_CALLS 0                          /*!<parameter2 of TOWER_COMMANDSTATS_CMD for the number of calls*/
+#define COMMANDSTATS_AVERAGE_CYCLES 1                 /*!<parameter2 of TOWER_COMMANDSTATS_CMD for the average cycles per call*/
+#define COMMANDSTATS_MAX_CYCLES 2                     /*!<parameter2 of TOWER_COMMANDSTATS_CMD for the most cycles in one call*/
+#define STATS_ALL 0xFF                                /*!<parameter1 of TOWER_STATS_CMD that asks for every counter*/
+/*! indices of the counters read with TOWER_STATS_CMD */
+enum
+{
+  STATS_BYTES_IN,
+  STATS_BYTES_OUT,
+  STATS_RX_HIGH_WATER,
+  STATS_RX_DROPPED,
+  STATS_TX_HIGH_WATER,
+  STATS_TX_DROPPED,
+  STATS_FRAMING_ERRORS,
+  STATS_OVERRUNS,
+  STATS_NOISE_ERRORS,
+  STATS_PACKETS_DROPPED,
+  STATS_CHECKSUM_ERRORS,
+  STATS_RX_PACKETS_DROPPED,
+  STATS_TELEMETRY_OVERWRITTEN,
+  STATS_BYTES_IN_HIGH,                                /*!<high half of the 32-bit count, STATS_BYTES_IN is the low half*/
+  STATS_BYTES_OUT_HIGH,                               /*!<high half of the 32-bit count, STATS_BYTES_OUT is the low half*/
+  STATS_NB
+};
+
+static TProtocolSetup Setup;                          /*!< the functions the handlers call */
+static uint16_t *towerNb;                             /*!< pointer to tower number. */
+static uint16_t *towerMd;                             /*!< pointer to tower towermode. */
+static uint32_t newBaudRate = 0;                      /*!< baud rate to switch to once the reply has been sent, 0 for none */
+static int8_t newChecksum = -1;                       /*!< checksum to switch to once the reply has been sent, -1 for none */
+
+/*! @brief Gets the tower number, the student number until one has been set.
+ *
+ *  @return uint16_t - The tower number.
+ */
+static uint16_t TowerNumber(void)
+{
+  uint16_t towerNumber = Flash_Read16(towerNb);
+
+  return (towerNumber == UNPROGRAMED_NUMBER) ? STUDENT_NUMBER : towerNumber;
+}
+
+/*! @brief Gets the tower mode, TOWER_INIT_MODE until one has been set.
+ *
+ *  @return uint16_t - The tower mode.
+ */
+static uint16_t TowerMode(void)
+{
+  uint16_t towerMode = Flash_Read16(towerMd);
+
+  return (towerMode == UNPROGRAMED_NUMBER) ? TOWER_INIT_MODE : towerMode;
+}
+
+/*! @brief handle the start_up_packet.
+ *  when tower is start up, it returns four packets.
+ *  @return BOOL - what the startup function returns, if the tower is start up.
+ */
+static BOOL Handle_Startup_Packet(const TPacket* const packet)
+{
+  if (PACKET_PARAMETER1(packet) == 0 && PACKET_PARAMETER2(packet) == 0 && PACKET_PARAMETER3(packet) == 0)
+  {
+    /*!this command is carried out*/
+    return Setup.startupFunction();
+  }
+  return bFALSE;
+}
+
+/*! @brief handle the GetVersion_Packet.
+ *  when receive get version packet, return the version number packet.
+ *  @return BOOL - Packet_Put() to get version.
+ */
+static BOOL Handle_GetVersion_Packet(const TPacket* const packet)
+{
+  if (PACKET_PARAMETER1(packet) == 'v' && PACKET_PARAMETER2(packet) == 'x' && PACKET_PARAMETER3(packet) == CR)
+  {
+    /*!tower will send back the tower version packet to PC*/
+    return Packet_Put(TOWER_GETVERSION_CMD,'v', MAJOR_VERSION_NUMBER, MINOR_VERSION_NUMBER);
+  }
+  return bFALSE;
+}
+
+/*! @brief handle the GetNumber_Packet.
+ *  when receive get number packet, return the number packet.
+ *  @return BOOL - Packet_Put() to GetNumber.
+ */
+static BOOL Handle_GetNumber_Packet(const TPacket* const packet)
+{
+  /*!when we choose get*/
+  if (PACKET_PARAMETER1(packet) == GET_TOWER_NUMBER && PACKET_PARAMETER2(packet) == 0 && PACKET_PARAMETER3(packet) == 0)
+  {
+    uint16union_t towerNumber;
+
+    towerNumber.l = TowerNumber();
+    /*!PC receive the tower number packet*/
+    return Packet_Put(TOWER_NUMBER_CMD, GET_TOWER_NUMBER, towerNumber.s.Lo, towerNumber.s.Hi);
+  }
+  /*!choose set number,we can set our student number into parameter23*/
+  if (PACKET_PARAMETER1(packet) == SET_TOWER_NUMBER)
+  {
+    /*!set the tower number by changing the value of parameter2 and parameter3 this have to write into flash*/
+    Flash_Write16((towerNb), PACKET_PARAMETER23(packet));
+    /*!PC receive the tower number we set*/
+    return Packet_Put(TOWER_NUMBER_CMD, SET_TOWER_NUMBER, PACKET_PARAMETER2(packet),PACKET_PARAMETER3(packet));
+  }
+  return bFALSE;
+}
+
+/*! @brief handle the TowerMode_Packet.
+ *  when receive tower mode packet, return the tower mode packet.
+ *  @return BOOL - Packet_Put() to get the tower mode.
+ */
+static BOOL Handle_TowerMode_Packet(const TPacket* const packet)
+{
+  /*!parameter1 is 1 means we choose get tower mode,when we choose get, parameter23 should be 0*/
+  if (PACKET_PARAMETER1(packet) == 1 && PACKET_PARAMETER2(packet) == 0 && PACKET_PARAMETER3(packet) == 0)
+  {
+    uint16union_t towerMode;
+
+    towerMode.l = TowerMode();
+    /*!PC receive the tower mode packet*/
+    return Packet_Put(TOWER_TOWERMODE_CMD, 1, towerMode.s.Lo, towerMode.s.Hi);
+  }
+  /*!choose set number,we can set any number into parameter23*/
+  if (PACKET_PARAMETER1(packet) == 2)
+  {
+    /*!set the tower mode by changing the value of parameter2 and parameter3 this have to write into flash*/
+    Flash_Write16(towerMd, PACKET_PARAMETER23(packet));
+    /*!PC receive the tower mode number we set before*/
+    return Packet_Put(TOWER_TOWERMODE_CMD,2,PACKET_PARAMETER2(packet), PACKET_PARAMETER3(packet));
+  }
+  return bFALSE;
+}
+
+/*! @brief handle the BaudRate_Packet.
+ *  parameter1 to parameter3 hold the new baud rate, least significant byte first.
+ *  the tower replies with the baud rate it can really run at, or 0 if that is too far off,
+ *  and switches once the reply and the acknowledgement have been sent.
+ *  @return BOOL - Packet_Put() to get the achieved baud rate, bFALSE if the rate cannot be used.
+ */
+static BOOL Handle_BaudRate_Packet(const TPacket* const packet)
+{
+  uint32_t baudRate = PACKET_PARAMETER1(packet) | ((uint32_t)PACKET_PARAMETER2(packet) << 8) | ((uint32_t)PACKET_PARAMETER3(packet) << 16);
+  uint32_t achieved = UART_AchievedBaudRate(baudRate);
+  uint32_t error;
+
+  /*!the error between the two ends of the link has to stay well inside the half bit the receiver allows over a frame*/
+  error = (achieved > baudRate) ? (achieved - baudRate) : (baudRate - achieved);
+  if (achieved == 0 || error * 100 > baudRate * MAX_BAUDRATE_ERROR)
+  {
+    Packet_Put(TOWER_BAUDRATE_CMD, 0, 0, 0);
+    return bFALSE;
+  }
+  newBaudRate = baudRate;
+  return Packet_Put(TOWER_BAUDRATE_CMD, achieved & 0xFF, (achieved >> 8) & 0xFF, (achieved >> 16) & 0xFF);
+}
+
+/*! @brief handle the Stats_Packet.
+ *  parameter1 is the index of a counter, or STATS_ALL for all of them, parameter23 should be 0.
+ *  each counter is sent back in its own packet: index, then the 16-bit value, low byte first.
+ *  the byte counts are 32 bits, sent as a low and a high half; asking for either half sends both,
+ *  low half first, so that the two halves are always from the same reading.
+ *  @return BOOL - Packet_Put() to get the counters.
+ */
+static BOOL Handle_Stats_Packet(const TPacket* const packet)
+{
+  TUARTStats uartStats;
+  uint32union_t bytesIn, bytesOut;
+  uint16union_t stats[STATS_NB];
+  uint8_t i, index = PACKET_PARAMETER1(packet);
+
+  if (PACKET_PARAMETER2(packet) != 0 || PACKET_PARAMETER3(packet) != 0 || (index >= STATS_NB && index != STATS_ALL))
+    return bFALSE;
+  /*!take every counter at the same moment, so that they can be compared*/
+  UART_GetStats(&uartStats);
+  bytesIn.l = uartStats.BytesIn;
+  bytesOut.l = uartStats.BytesOut;
+  stats[STATS_BYTES_IN].l = bytesIn.s.Lo;
+  stats[STATS_BYTES_IN_HIGH].l = bytesIn.s.Hi;
+  stats[STATS_BYTES_OUT].l = bytesOut.s.Lo;
+  stats[STATS_BYTES_OUT_HIGH].l = bytesOut.s.Hi;
+  stats[STATS_RX_HIGH_WATER].l = uartStats.RxHighWater;
+  stats[STATS_RX_DROPPED].l = uartStats.RxDropped;
+  stats[STATS_TX_HIGH_WATER].l = uartStats.TxHighWater;
+  stats[STATS_TX_DROPPED].l = uartStats.TxDropped;
+  stats[STATS_FRAMING_ERRORS].l = uartStats.FramingErrors;
+  stats[STATS_OVERRUNS].l = uartStats.Overruns;
+  stats[STATS_NOISE_ERRORS].l = uartStats.NoiseErrors;
+  stats[STATS_PACKETS_DROPPED].l = Packet_NbDropped();
+  stats[STATS_CHECKSUM_ERRORS].l = Packet_NbChecksumErrors();
+  stats[STATS_RX_PACKETS_DROPPED].l = Packet_NbRxDropped();
+  stats[STATS_TELEMETRY_OVERWRITTEN].l = Packet_NbOverwritten();
+
+  if (index == STATS_BYTES_IN || index == STATS_BYTES_IN_HIGH)
+    return Packet_Put(TOWER_STATS_CMD, STATS_BYTES_IN, stats[STATS_BYTES_IN].s.Lo, stats[STATS_BYTES_IN].s.Hi) &&
+           Packet_Put(TOWER_STATS_CMD, STATS_BYTES_IN_HIGH, stats[STATS_BYTES_IN_HIGH].s.Lo, stats[STATS_BYTES_IN_HIGH].s.Hi);
+  if (index == STATS_BYTES_OUT || index == STATS_BYTES_OUT_HIGH)
+    return Packet_Put(TOWER_STATS_CMD, STATS_BYTES_OUT, stats[STATS_BYTES_OUT].s.Lo, stats[STATS_BYTES_OUT].s.Hi) &&
+           Packet_Put(TOWER_STATS_CMD, STATS_BYTES_OUT_HIGH, stats[STATS_BYTES_OUT_HIGH].s.Lo, stats[STATS_BYTES_OUT_HIGH].s.Hi);
+  if (index != STATS_ALL)
+    return Packet_Put(TOWER_STATS_CMD, index, stats[index].s.Lo, stats[index].s.Hi);
+  for (i = 0; i < STATS_NB; i++)
+    if (!Packet_Put(TOWER_STATS_CMD, i, stats[i].s.Lo, stats[i].s.Hi))
+      return bFALSE;
+  return bTRUE;
+}
+
+/*! @brief handle the Extended_Packet.
+ *  parameter1 is 1 to send the time and accelerometer packets as extended frames, with a sequence number and
+ *  the time in microseconds, or 0 to send them as plain packets again. parameter23 should be 0.
+ *  @return BOOL - Packet_Put() to get the setting back, bFALSE if it is out of range.
+ */
+static BOOL Handle_Extended_Packet(const TPacket* const packet)
+{
+  if (PACKET_PARAMETER1(packet) > 1 || PACKET_PARAMETER23(packet) != 0)
+    return bFALSE;
+  Packet_SetExtended(PACKET_PARAMETER1(packet) ? TOWER_EXTENDED_CMD : 0, Setup.microsecondsFunction);
+  return Packet_Put(TOWER_EXTENDED_CMD, PACKET_PARAMETER1(packet), 0, 0);
+}
+
+/*! @brief handle the Checksum_Packet.
+ *  parameter1 is 0 to check packets with the XOR of their bytes, 1 to check them with a CRC-8, see CRC.h.
+ *  parameter23 should be 0. the reply and the acknowledgement are still checked the old way, the new
+ *  checksum is used from the next byte in and the next packet out after them.
+ *  @return BOOL - Packet_Put() to get the setting back, bFALSE if it is out of range.
+ */
+static BOOL Handle_Checksum_Packet(const TPacket* const packet)
+{
+  if (PACKET_PARAMETER1(packet) > 1 || PACKET_PARAMETER23(packet) != 0)
+    return bFALSE;
+  newChecksum = PACKET_PARAMETER1(packet) ? PACKET_CHECKSUM_CRC8 : PACKET_CHECKSUM_XOR;
+  return Packet_Put(TOWER_CHECKSUM_CMD, PACKET_PARAMETER1(packet), 0, 0);
+}
+
+/*! @brief handle the CommandStats_Packet.
+ *  parameter1 is a command, parameter2 picks its number of calls, average cycles per call or most cycles in one call.
+ *  the value is sent back in parameter2 and parameter3, low byte first, and is 0xFFFF if it does not fit.
+ *  @return BOOL - Packet_Put() to get the counter.
+ */
+static BOOL Handle_CommandStats_Packet(const TPacket* const packet)
+{
+  TCommandStats stats;
+  uint32_t value;
+  uint16union_t reply;
+
+  if (PACKET_PARAMETER3(packet) != 0 || !Command_GetStats(PACKET_PARAMETER1(packet), &stats))
+    return bFALSE;
+  switch (PACKET_PARAMETER2(packet))
+  {
+    case COMMANDSTATS_CALLS:
+      value = stats.NbCalls;
+      break;
+    case COMMANDSTATS_AVERAGE_CYCLES:
+      value = stats.NbCalls ? stats.NbCycles / stats.NbCalls : 0;
+      break;
+    case COMMANDSTATS_MAX_CYCLES:
+      value = stats.MaxCycles;
+      break;
+    default:
+      return bFALSE;
+  }
+  reply.l = (value > 0xFFFF) ? 0xFFFF : value;
+  return Packet_Put(TOWER_COMMANDSTATS_CMD, PACKET_PARAMETER1(packet), reply.s.Lo, reply.s.Hi);
+}
+
+
+BOOL Protocol_Init(const TProtocolSetup* const setup)
+{
+  Setup = *setup;
+  newBaudRate = 0;
+  newChecksum = -1;
+  /*Allocate the address for tower number and tower mode.*/
+  return Flash_AllocateVar((volatile void **)&towerNb, sizeof(*towerNb)) &&
+         Flash_AllocateVar((volatile void **)&towerMd, sizeof(*towerMd)) &&
+         Command_Register(TOWER_STARTUP_CMD, Handle_Startup_Packet) &&
+         Command_Register(TOWER_GETVERSION_CMD, Handle_GetVersion_Packet) &&
+         Command_Register(TOWER_NUMBER_CMD, Handle_GetNumber_Packet) &&
+         Command_Register(TOWER_TOWERMODE_CMD, Handle_TowerMode_Packet) &&
+         Command_Register(TOWER_BAUDRATE_CMD, Handle_BaudRate_Packet) &&
+         Command_Register(TOWER_STATS_CMD, Handle_Stats_Packet) &&
+         Command_Register(TOWER_COMMANDSTATS_CMD, Handle_CommandStats_Packet) &&
+         Command_Register(TOWER_EXTENDED_CMD, Handle_Extended_Packet) &&
+         Command_Register(TOWER_CHECKSUM_CMD, Handle_Checksum_Packet);
+}
+
+
+BOOL Protocol_SendStartup(void)
+{
+  uint16union_t towerNumber;        /*! a 16 bit towerNumber */
+  uint16union_t towerMode;          /*! a 16 bit towerMode */
+
+  towerNumber.l = TowerNumber();
+  towerMode.l = TowerMode();
+  return Packet_Put(TOWER_STARTUP_CMD, 0, 0, 0) &&
+         Packet_Put(TOWER_GETVERSION_CMD,'v', MAJOR_VERSION_NUMBER, MINOR_VERSION_NUMBER) &&
+         Packet_Put(TOWER_NUMBER_CMD, GET_TOWER_NUMBER, towerNumber.s.Lo, towerNumber.s.Hi) &&
+         Packet_Put(TOWER_TOWERMODE_CMD,1,towerMode.s.Lo, towerMode.s.Hi);
+}
+
+
+void Protocol_HandlePackets(void)
+{
+  /*!used to check the bit7 of the Packet_Command is 0/1*/
+  uint8 ACK = 0;
+  /*!check if the packet from PC Tower is right can used, if not, bFALSE*/
+  BOOL Carried_Out = bFALSE;
+
+  /*!handle every packet that has arrived, not just one per pass of the main loop, but none while a baud
+     rate change is pending, since no reply could go out; those packets wait in RxFIFO for the next pass*/
+  while (!UART_BaudRatePending() && Packet_Get())
+  {
+    if (Setup.receivedCallbackFunction)
+      Setup.receivedCallbackFunction();
+    /*!the replies to a tagged request, the acknowledgement included, carry its tag*/
+    Packet_TagReplies(bTRUE);
+    /*!first block the first bit of the Packet_Command for the Packet Acknowledgment,XXXX XXXX& 1000 0000 to get ACK = X000 0000*/
+    ACK = (Packet_Command & ACK_MASK);
+    /*!Packet_Command = XXXX XXXX& 0111 1111 = 0XXX XXXX, use this way to block the bit7 of the command*/
+    Packet_Command &= ~ACK_MASK;
+    /*!the handler registered for the command carries it out*/
+    Carried_Out = Command_Dispatch(&Packet);
+    /*!X000 0000=1000 0000 (means if bit7 is 1, the Packet_Command is 0x8X) and the packet from tower to PC is right ones*/
+    if ((ACK == ACK_MASK) && Carried_Out)
+      /*!if so, packets transmitted from PC to Tower will not only three before, another fourth packet will be transmitted with a packet command 0x8X*/
+      Packet_Put(Packet_Command|ACK, Packet_Parameter1, Packet_Parameter2, Packet_Parameter3);
+    /*!X000 0000=1000 0000 (means if bit7 is 1, the Packet_Command is 0x8X) and the packet from tower to PC is not right ones*/
+    if ((ACK == ACK_MASK) && !Carried_Out)
+      /*!if so, the packet command of the packet transmitted from PC to Tower is 0x0X*/
+      Packet_Put(Packet_Command&~ACK, Packet_Parameter1, Packet_Parameter2, Packet_Parameter3);
+    Packet_TagReplies(bFALSE);
+    /*!the new baud rate is only switched to after the reply and the acknowledgement, which go out at the old one*/
+    if (newBaudRate)
+    {
+      if (Carried_Out)
+        (void)UART_SetBaudRate(newBaudRate);
+      newBaudRate = 0;
+    }
+    /*!so is the new checksum, so that the PC can still check the reply the old way*/
+    if (newChecksum >= 0)
+    {
+      if (Carried_Out)
+        Packet_SetChecksum((TPacketChecksum)newChecksum);
+      newChecksum = -1;
+    }
+  }
+}
+
+/* END protocol */
+/*!
+** @}
+*/
@@ -0,0 +1,67 @@
+/*! @file
+ *
+ *  @brief Routines to receive packets and carry out the commands that only need the serial stack.
+ *
+ *  This contains the packet loop, with its acknowledgements, and the handlers of the startup, version,
+ *  tower number, tower mode, baud rate, checksum, extended frame and counter commands. The tower and
+ *  the virtual tower on the PC both build it, and register the rest of their commands themselves.
+ *
+ *  @author Liang Wang
+ *  @date 2016-08-16
+ */
+
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+// new types
+#include "types.h"
+
+// Commands carried out here
+#define TOWER_STARTUP_CMD 0x04                        /*!<0x04 is TOWER_STARTUP_CMD*/
+#define TOWER_GETVERSION_CMD 0x09                     /*!<0x09 is TOWER_GETVERSION_CMD*/
+#define TOWER_NUMBER_CMD 0x0B                         /*!<0x0B is TOWER_NUMBER_CMD*/
+#define TOWER_TOWERMODE_CMD 0x0D                      /*!<0x0D is TOWER_TOWERMODE_CMD*/
+#define TOWER_BAUDRATE_CMD 0x0F                       /*!<0x0F is TOWER_BAUDRATE_CMD*/
+#define TOWER_STATS_CMD 0x11                          /*!<0x11 is TOWER_STATS_CMD*/
+#define TOWER_COMMANDSTATS_CMD 0x12                   /*!<0x12 is TOWER_COMMANDSTATS_CMD*/
+#define TOWER_EXTENDED_CMD 0x15                       /*!<0x15 is TOWER_EXTENDED_CMD, also the command of the extended telemetry frames*/
+#define TOWER_CHECKSUM_CMD 0x16                       /*!<0x16 is TOWER_CHECKSUM_CMD*/
+
+// Bit 7 of a command asks for an acknowledgement
+#define ACK_MASK 0x80
+
+/*!
+ * @struct TProtocolSetup
+ */
+typedef struct
+{
+  BOOL (*startupFunction)(void);                /*!< Sends the startup packets, called for TOWER_STARTUP_CMD. */
+  uint32_t (*microsecondsFunction)(void);       /*!< The clock extended frames are stamped with, see Packet_SetExtended. */
+  void (*receivedCallbackFunction)(void);       /*!< Called for each packet received, before it is handled, NULL for none. */
+} TProtocolSetup;
+
+/*! @brief Allocates the tower number and mode in flash and registers the handlers of the commands above.
+ *
+ *  @param setup The functions the handlers call, which differ between the tower and the PC.
+ *  @return BOOL - TRUE if the variables were allocated and every handler was registered.
+ *  @note Assumes that Packet_Init, Command_Init and Flash_Init have been called.
+ */
+BOOL Protocol_Init(const TProtocolSetup* const setup);
+
+/*! @brief Sends the startup, version, tower number and tower mode packets.
+ *
+ *  @return BOOL - TRUE if the packets were queued.
+ *  @note Assumes that Protocol_Init has been called.
+ */
+BOOL Protocol_SendStartup(void);
+
+/*! @brief Receives every packet that has arrived and hands it to the handler registered for its command.
+ *
+ *  A packet asking for an acknowledgement gets one after the reply. A new baud rate or checksum is
+ *  only switched to after both, and no packet is taken while a baud rate change is pending.
+ *  @return void
+ *  @note Assumes that Protocol_Init has been called.
+ */
+void Protocol_HandlePackets(void);
+
+#endif
@@ -0,0 +1,149 @@
+/*! @file
+ *
+ *  @brief stream module: Routines to send accelerometer samples to the PC in batches.
+ *
+ *  This module contains the functions for collecting timestamped samples into a frame.
+ *
+ *  @author Liang Wang
+ *  @date 2016-08-01
+ */
+/*!
+**  @addtogroup stream_module stream module documentation
+**  @{
+*/
+/* MODULE stream */
+#include "stream.h"
+#include "packet.h"
+#include "delta.h"
+#include "Cpu.h"
+#include "MK70F12.h"
+
+static uint8_t RawCommand;                    /*!< command of raw frames*/
+static uint8_t DeltaCommand;                  /*!< command of delta encoded frames*/
+static TStreamMode Mode;                      /*!< how the samples are encoded*/
+static uint8_t NbSamplesPerFrame;             /*!< samples that fill a frame, 0 when batching is off*/
+static uint16_t Timeout;                      /*!< ticks the first sample of a frame may wait*/
+
+static uint8_t Frame[PACKET_FRAME_MAX_DATA];  /*!< frame data being collected*/
+static TDeltaEncoder Encoder;                 /*!< encodes into Frame in delta mode*/
+static uint8_t NbSamples;                     /*!< samples in Frame*/
+static uint16_t FirstTime;                    /*!< time of the first sample in Frame*/
+static uint16_t LastTime;                     /*!< time the PC works out for the last sample in Frame*/
+
+
+BOOL Stream_Init(const uint8_t rawCommand, const uint8_t deltaCommand)
+{
+  RawCommand = rawCommand;
+  DeltaCommand = deltaCommand;
+  Mode = STREAM_RAW;
+  NbSamplesPerFrame = 0;
+  NbSamples = 0;
+  return bTRUE;
+}
+
+
+BOOL Stream_Set(const TStreamMode mode, const uint8_t nbSamples, const uint16_t timeout)
+{
+  if (nbSamples > ((mode == STREAM_DELTA) ? STREAM_MAX_DELTA_SAMPLES : STREAM_MAX_SAMPLES) || timeout > STREAM_MAX_TIMEOUT)
+    return bFALSE;
+  EnterCritical();
+  (void)Stream_Flush();
+  Mode = mode;
+  NbSamplesPerFrame = nbSamples;
+  Timeout = (uint16_t)(((uint32_t)timeout * STREAM_TICKS_PER_SECOND) / 1000);
+  ExitCritical();
+  return bTRUE;
+}
+
+
+BOOL Stream_IsOn(void)
+{
+  return NbSamplesPerFrame != 0;
+}
+
+
+BOOL Stream_Flush(void)
+{
+  BOOL success = bTRUE;
+
+  EnterCritical();
+  if (NbSamples && Mode == STREAM_DELTA)
+    success = Packet_PutTelemetryFrame(DeltaCommand, Frame, Delta_NbBytes(&Encoder));
+  else if (NbSamples)
+    success = Packet_PutTelemetryFrame(RawCommand, Frame, STREAM_HEADER_NB_BYTES + NbSamples * STREAM_SAMPLE_NB_BYTES);
+  /*!a frame that did not fit in the telemetry queue is dropped, the PC sees the gap in the times*/
+  NbSamples = 0;
+  ExitCritical();
+  return success;
+}
+
+
+void Stream_Put(const uint8_t data[3])
+{
+  uint16_t now = FTM0_CNT;
+  uint16_t dt;
+  uint8_t *sample;
+
+  EnterCritical();
+  if (NbSamplesPerFrame == 0)
+  {
+    ExitCritical();
+    return;
+  }
+  /*!the time since the sample before has to fit in 8 bits*/
+  dt = (uint16_t)(now - LastTime) >> STREAM_DT_SHIFT;
+  if (NbSamples && dt > 0xFF)
+    (void)Stream_Flush();
+  if (NbSamples == 0)
+  {
+    FirstTime = now;
+    LastTime = now;
+    dt = 0;
+    if (Mode == STREAM_DELTA)
+      Delta_Start(&Encoder, Frame, sizeof(Frame), now, data);
+    else
+    {
+      Frame[0] = now & 0xFF;
+      Frame[1] = now >> 8;
+    }
+  }
+  else if (Mode == STREAM_DELTA && !Delta_Add(&Encoder, (uint8_t)dt, data))
+  {
+    /*!no room left, the sample starts the next frame*/
+    (void)Stream_Flush();
+    FirstTime = now;
+    LastTime = now;
+    dt = 0;
+    Delta_Start(&Encoder, Frame, sizeof(Frame), now, data);
+  }
+  /*!move on by what the PC adds up, so that rounding does not build up over a frame*/
+  LastTime += dt << STREAM_DT_SHIFT;
+  if (Mode == STREAM_RAW)
+  {
+    sample = &Frame[STREAM_HEADER_NB_BYTES + NbSamples * STREAM_SAMPLE_NB_BYTES];
+    sample[0] = (uint8_t)dt;
+    sample[1] = data[0];
+    sample[2] = data[1];
+    sample[3] = data[2];
+  }
+  NbSamples++;
+  if (NbSamples >= NbSamplesPerFrame)
+    (void)Stream_Flush();
+  ExitCritical();
+}
+
+
+void Stream_Poll(void)
+{
+  uint16_t now = FTM0_CNT;
+
+  EnterCritical();
+  if (NbSamples && (uint16_t)(now - FirstTime) >= Timeout)
+    (void)Stream_Flush();
+  ExitCritical();
+}
+
+/* END stream */
+/*!
+** @}
+*/
@@ -0,0 +1,91 @@
+/*! @file
+ *
+ *  @brief Routines to send accelerometer samples to the PC in batches.
+ *
+ *  This contains the functions for collecting timestamped samples and sending many of them in one
+ *  variable length frame, instead of one 5-byte packet each.
+ *
+ *  @author Liang Wang
+ *  @date 2016-08-01
+ */
+
+#ifndef STREAM_H
+#define STREAM_H
+
+// new types
+#include "types.h"
+
+// Most samples in one frame: raw samples take 4 bytes each, delta encoded ones fill the frame as far as they fit
+#define STREAM_MAX_SAMPLES 32
+#define STREAM_MAX_DELTA_SAMPLES 255
+
+typedef enum
+{
+  STREAM_RAW,                 /*!< x, y and z bytes as they are, see below*/
+  STREAM_DELTA                /*!< changes from the sample before, see delta.h*/
+} TStreamMode;
+
+// Sample times are FTM0 counter ticks, the counter runs from the 24414 Hz fixed frequency clock;
+// the time between samples is sent in units of 2^STREAM_DT_SHIFT ticks (about 0.66 ms), up to 255 units
+#define STREAM_TICKS_PER_SECOND 24414
+#define STREAM_DT_SHIFT 4
+
+// Longest timeout in ms, well inside the 2.68 s it takes the 16-bit counter to wrap
+#define STREAM_MAX_TIMEOUT 2000
+
+// Raw frame data: the time of the first sample (16 bits, low byte first), then for each sample
+// the time since the one before it (8 bits, 0 for the first sample) and the x, y and z bytes.
+// Delta frame data is laid out by the delta module, with the same time steps; every frame starts
+// with a keyframe, so a lost frame does not stop the next one from being decoded
+#define STREAM_HEADER_NB_BYTES 2
+#define STREAM_SAMPLE_NB_BYTES 4
+
+/*! @brief Sets up batching before first use, with batching off.
+ *
+ *  @param rawCommand The command of raw frames.
+ *  @param deltaCommand The command of delta encoded frames.
+ *  @return BOOL - TRUE if the stream module was successfully initialized.
+ *  @note Assumes that FTM_Init has been called.
+ */
+BOOL Stream_Init(const uint8_t rawCommand, const uint8_t deltaCommand);
+
+/*! @brief Sets how many samples make a frame and how long a sample may wait to be sent.
+ *
+ *  Anything collected so far is sent first.
+ *  @param mode How the samples are encoded.
+ *  @param nbSamples The number of samples per frame, up to STREAM_MAX_SAMPLES raw or STREAM_MAX_DELTA_SAMPLES delta encoded,
+ *                   0 to turn batching off.
+ *  @param timeout The longest time in ms from a sample being collected to its frame being sent, at most STREAM_MAX_TIMEOUT.
+ *  @return BOOL - TRUE if the settings are in range.
+ */
+BOOL Stream_Set(const TStreamMode mode, const uint8_t nbSamples, const uint16_t timeout);
+
+/*! @brief Tells whether samples are being batched.
+ *
+ *  @return BOOL - TRUE if samples should go to Stream_Put.
+ */
+BOOL Stream_IsOn(void);
+
+/*! @brief Collects a sample, stamped with the time now.
+ *
+ *  The frame is sent when it is full, or before the sample when the sample does not fit.
+ *  @param data The x, y and z bytes.
+ *  @return void
+ *  @note Can be called from the accelerometer's interrupt callbacks.
+ */
+void Stream_Put(const uint8_t data[3]);
+
+/*! @brief Sends the frame if its first sample has waited for the timeout.
+ *
+ *  @return void
+ *  @note Called from the main loop.
+ */
+void Stream_Poll(void);
+
+/*! @brief Sends the samples collected so far.
+ *
+ *  @return BOOL - TRUE if there was nothing to send or the frame was queued.
+ */
+BOOL Stream_Flush(void);
+
+#endif